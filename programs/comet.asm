@@ -0,0 +1,26 @@
+# Port of the Comet pattern, simplified: a single comet with a fading trail runs down a random column, drawn at 8 bits
+        rows r0
+        cols r1
+        set r2 8
+        div r3 r0 r2            # comet size
+        addi r4 r1 1            # speed
+        rand r5 r1              # column
+        set r6 0                # position
+        set r7 100              # fade amount
+        set r8 30               # frame duration
+move:   jlt r6 r0 draw
+        jmp fadeout
+draw:   fadecol r5 r7
+        span r5 r6 r3
+        show r8
+        add r6 r6 r4
+        jmp move
+fadeout:
+        fadecol r5 r7
+        show r8
+        lit r9 r5
+        jnz r9 fadeout
+        set r10 1000
+        rand r10 r10
+        addi r10 r10 10
+        end r10
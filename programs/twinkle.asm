@@ -0,0 +1,25 @@
+# Port of the Twinkle pattern: lights up 5 - 49 random spots of 1 - 3 pixels for a single frame
+        rows r0
+        cols r1
+        set r2 2                # for coin flips
+        set r3 45
+        rand r4 r3
+        addi r4 r4 5            # number of spots
+spot:   jz r4 done
+        rand r5 r1              # column
+        rand r6 r0              # row
+        pixel r5 r6
+        rand r7 r2              # light up neighboring pixels with 50% probability each
+        jz r7 right
+        addi r8 r6 -1
+        pixel r5 r8
+right:  rand r7 r2
+        jz r7 next
+        addi r8 r6 1
+        pixel r5 r8
+next:   addi r4 r4 -1
+        jmp spot
+done:   set r9 0
+        show r9
+        rand r9 r2
+        end r9
@@ -0,0 +1,31 @@
+# PlatformIO pre-build script: gzips every file in web/ into data/ so that the LittleFS image
+# (pio run --target uploadfs) only contains precompressed assets.
+# ESPAsyncWebServer serves "<file>.gz" with "Content-Encoding: gzip" when "<file>" is requested.
+import gzip
+import os
+import shutil
+
+Import("env")
+
+SOURCE_DIR = os.path.join(env.subst("$PROJECT_DIR"), "web")
+DATA_DIR = env.subst("$PROJECT_DATA_DIR")
+
+
+def compress_web_assets():
+    if not os.path.isdir(SOURCE_DIR):
+        return
+    for root, _, files in os.walk(SOURCE_DIR):
+        for name in files:
+            source = os.path.join(root, name)
+            target = os.path.join(DATA_DIR, os.path.relpath(source, SOURCE_DIR)) + ".gz"
+            if os.path.exists(target) and os.path.getmtime(target) >= os.path.getmtime(source):
+                continue
+            os.makedirs(os.path.dirname(target), exist_ok=True)
+            with open(source, "rb") as source_file, open(target, "wb") as target_file:
+                # mtime=0 keeps the output byte-identical for unchanged input
+                with gzip.GzipFile(filename="", mode="wb", fileobj=target_file, compresslevel=9, mtime=0) as gz:
+                    shutil.copyfileobj(source_file, gz)
+            print("Compressed %s -> %s" % (source, target))
+
+
+compress_web_assets()
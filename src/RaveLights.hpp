@@ -1,9 +1,21 @@
 #pragma once
 
 #include "ESPAsyncWebServer.h"
+#include "LittleFS.h"
+#include "Preferences.h"
+#include "audio/AudioAnalyzer.hpp"
+#include "palette/Palette.hpp"
 #include "patterns/AbstractPattern.hpp"
+#include "preview/PreviewStream.hpp"
+#include "render/ColumnWorkerPool.hpp"
+#include "render/Quantizer.hpp"
+#include "render/Rgb16.hpp"
+#include "sequencer/CueListPlayer.hpp"
+#include "timing/Clock.hpp"
+#include "timing/FrameScheduler.hpp"
 #define FASTLED_ESP32_I2S  // Alternative parallel output driver
 #include <FastLED.h>
+#include <algorithm>
 #include <atomic>
 #include <mutex>
 #include <thread>
@@ -17,58 +29,184 @@ template <int PIN_COUNT, const std::array<int, PIN_COUNT> &PINS, EOrder RGB_ORDE
         unsigned patternIndex{0};
     };
 
+    enum class CueListCommand { NONE, START, STOP };
+
    public:
-    RaveLights(const std::array<int, PIN_COUNT> &lightsPerPin, int pixelsPerLight = 144, uint8_t maxBrightness = 255)
-        : PIXELS_PER_LIGHT_(pixelsPerLight), MAX_BRIGHTNESS_(maxBrightness), server_(80) {
+    // Pass a Timing::VirtualClock to run the show faster than real time
+    RaveLights(const std::array<int, PIN_COUNT> &lightsPerPin, int pixelsPerLight = 144, uint8_t maxBrightness = 255,
+               std::shared_ptr<Timing::Clock> clock = std::make_shared<Timing::RealClock>())
+        : PIXELS_PER_LIGHT_(pixelsPerLight), MAX_BRIGHTNESS_(maxBrightness), server_(80), clock_(clock),
+          frameScheduler_(*clock_, [] { FastLED.show(); }),
+          cueListPlayer_([this](const Sequencer::Cue &cue) { dispatchCue(cue); }) {
         static_assert(PIN_COUNT == 4, "setupFastLed() is currently hardcoded to handle exactly 4 pins!");
         setupFastled(lightsPerPin);
+        preview_.init(PIXELS_PER_LIGHT_, LIGHT_COUNT_);
+        pendingParameterCues_.reserve(MAX_PENDING_PARAMETER_CUE_COUNT_);
         setupRequestHandlers();
     }
 
+    // Shows red, green and blue for a second each. Use requestSelfTest() once the show loop is running.
     void testLeds() {
         std::vector<CRGB> colors{CRGB::Red, CRGB::Green, CRGB::Blue};
         for (const auto color : colors) {
-            auto timeBefore = millis();
+            auto timeBefore = clock_->nowUs();
             FastLED.showColor(color);
-            auto passedTime = millis() - timeBefore;
+            unsigned long passedTime = clock_->nowUs() - timeBefore;
             Serial.print("show() took ");
             Serial.print(passedTime);
-            Serial.println(" ms");
-            delay(500);
+            Serial.println(" us");
+            clock_->delayMs(500);
             FastLED.clear(true);
-            delay(500);
+            clock_->delayMs(500);
         }
     }
 
     void addPattern(std::shared_ptr<Pattern::AbstractPattern> pattern) {
         pattern->init(PIXELS_PER_LIGHT_, LIGHT_COUNT_);
+        pattern->setFrameScheduler(&frameScheduler_);
+        pattern->setWorkerPool(workerPool_.get());
+        pattern->setHighDepthBuffer(&highDepthLeds_);
         patterns_.push_back(pattern);
     }
 
-    void startWebServer() { server_.begin(); }
+    // Lets patterns render columns in parallel on workerCount additional threads pinned to the given core.
+    // Must be called before startShowLoop().
+    void enableParallelRendering(unsigned workerCount, int core = 0) {
+        workerPool_ = std::make_shared<Render::ColumnWorkerPool>(workerCount, core);
+        for (auto &pattern : patterns_) {
+            pattern->setWorkerPool(workerPool_.get());
+        }
+    }
+
+    // Runs testLeds() in the show loop between two performs
+    void requestSelfTest() { isSelfTestRequested_ = true; }
+
+    // Restores the pattern, color and brightness that were active before the last reset, so that the show resumes
+    // right away after a brownout. Call after adding patterns and before startShowLoop().
+    void restorePatternConfig() {
+        PatternConfig config;
+        Preferences preferences;
+        // Fails on first boot, in which case the defaults are returned
+        preferences.begin(PREFERENCES_NAMESPACE_, true);
+        config.patternIndex = preferences.getUInt("pattern", config.patternIndex);
+        config.color = preferences.getUInt("color", config.color);
+        config.brightness = preferences.getUChar("brightness", config.brightness);
+        preferences.end();
+        if (config.patternIndex >= patterns_.size()) {
+            config.patternIndex = 0;
+        }
+        nextPatternConfig_ = config;
+        persistedPatternConfig_ = config;
+        updatePatternConfig();
+    }
+
+    // Writes the pattern config to flash if it has changed. Every write wears the flash, so call this periodically
+    // (every few seconds) instead of on every change.
+    void persistPatternConfig() {
+        const PatternConfig config = nextPatternConfig_;
+        if (config.patternIndex == persistedPatternConfig_.patternIndex &&
+            config.color == persistedPatternConfig_.color && config.brightness == persistedPatternConfig_.brightness) {
+            return;
+        }
+        Preferences preferences;
+        if (!preferences.begin(PREFERENCES_NAMESPACE_, false)) {
+            Serial.println("Error. Could not open preferences, pattern config is not persisted.");
+            return;
+        }
+        preferences.putUInt("pattern", config.patternIndex);
+        preferences.putUInt("color", config.color);
+        preferences.putUChar("brightness", config.brightness);
+        preferences.end();
+        persistedPatternConfig_ = config;
+    }
+
+    // Gamma correction of patterns that use the 16 bit led buffer, 1 keeps values linear
+    void setOutputGamma(float gamma) { quantizer_.setGamma(gamma); }
+
+    // Plays the uploaded cue list (see setupCueListRequestHandler()) from its start. May be called from any thread.
+    void startCueList() { cueListCommand_ = CueListCommand::START; }
+    void stopCueList() { cueListCommand_ = CueListCommand::STOP; }
+
+    int64_t getFirstFrameTimeUs() const { return frameScheduler_.getFirstFrameTimeUs(); }
+
+    // Makes audio features available to patterns. Must be called before startShowLoop(), the analyzer may be started
+    // later. Its features are inactive until then.
+    void setAudioAnalyzer(std::shared_ptr<Audio::AudioAnalyzer> audioAnalyzer) { audioAnalyzer_ = audioAnalyzer; }
+
+    void startWebServer() {
+        // The control UI is served from flash. Upload it using `pio run --target uploadfs`.
+        if (!LittleFS.begin()) {
+            Serial.println("Error. Could not mount LittleFS, control UI is unavailable.");
+        } else {
+            indexETag_ = hashFileForETag(COMPRESSED_INDEX_PATH_);
+        }
+        server_.begin();
+    }
 
     void show() {
         while (!stopShowLoop_) {
+            if (isSelfTestRequested_.exchange(false)) {
+                testLeds();
+                frameScheduler_.resync();
+            }
             FastLED.clear(false);
-            unsigned long offDurationMs =
-                patterns_[currentPatternConfig_.patternIndex]->perform(leds_, currentPatternConfig_.color);
-            unsigned long currentTimeMs = millis();
+            // Palette uploads only become visible between two performs
+            palette_.swapIfPending();
+            // Parameter cues that fired during the previous perform
+            applyPendingParameterCues();
+            auto &pattern = patterns_[currentPatternConfig_.patternIndex];
+            pattern->setPalette(palette_.getActive());
+            if (audioAnalyzer_) {
+                pattern->setAudioFeatures(audioAnalyzer_->getFeatures());
+            }
+            const bool usesHighDepthBuffer = pattern->usesHighDepthBuffer();
+            if (usesHighDepthBuffer) {
+                std::fill(highDepthLeds_.begin(), highDepthLeds_.end(), Render::Rgb16());
+            }
+            frameScheduler_.setOutputPass([this, usesHighDepthBuffer] {
+                if (usesHighDepthBuffer) {
+                    quantizer_.convert(highDepthLeds_, leds_);
+                }
+                preview_.capture(leds_);
+                // Cues also fire during long performs, pattern cues interrupt programs (see requestPatternChange()) and
+                // parameter cues wait for the perform to end
+                updateCueList();
+            });
+            unsigned long offDurationMs = pattern->perform(leds_, currentPatternConfig_.color);
+            // Only onsets during the off duration trigger the next perform()
+            uint32_t onsetCount = audioAnalyzer_ ? audioAnalyzer_->getFeatures().onsetCount : 0;
+            // The off duration starts when the last frame of perform() ends, not when perform() returns
+            frameScheduler_.hold(offDurationMs * 1000);
             do {
+                // Cues are dispatched with every frame and while waiting, pattern changes take effect right below
+                updateCueList();
                 {  // Begin of scope guarded by mutex
                     // Leave waiting loop prematurely if pattern change is requested by asynchronous web server thread
                     std::lock_guard<std::mutex> lockGuard(isPatternUpdatePendingMutex_);
                     if (isPatternUpdatePending_) {
                         currentPatternConfig_.patternIndex = nextPatternConfig_.patternIndex;
                         isPatternUpdatePending_ = false;
+                        frameScheduler_.resync();
                         break;
                     }
                 }  // End of scope guarded by mutex
-            } while (millis() - currentTimeMs < offDurationMs);
+                // Leave waiting loop prematurely on a kick if the pattern is supposed to follow the music
+                if (audioAnalyzer_ && pattern->isTriggeredByOnsets() &&
+                    audioAnalyzer_->getFeatures().onsetCount != onsetCount) {
+                    frameScheduler_.resync();
+                    break;
+                }
+                frameScheduler_.waitForDeadline(1000);
+            } while (!frameScheduler_.isDeadlineReached());
             updatePatternConfig();
         }
     }
 
-    void startShowLoop() { showLoopThread_ = std::thread(&RaveLights::show, this); }
+    void startShowLoop() {
+        updatePatternConfig();
+        frameScheduler_.resync();
+        showLoopThread_ = std::thread(&RaveLights::show, this);
+    }
 
     void stopShowLoop() {
         stopShowLoop_ = true;
@@ -83,20 +221,50 @@ template <int PIN_COUNT, const std::array<int, PIN_COUNT> &PINS, EOrder RGB_ORDE
     int LIGHT_COUNT_;
 
     std::vector<CRGB> leds_;
+    std::vector<Render::Rgb16> highDepthLeds_;
+    Render::Quantizer quantizer_;
+    Preview::PreviewStream preview_;
     std::vector<std::shared_ptr<Pattern::AbstractPattern>> patterns_;
     bool isPatternUpdatePending_{false};
     std::mutex isPatternUpdatePendingMutex_;
     AsyncWebServer server_;
     struct PatternConfig currentPatternConfig_;
     struct PatternConfig nextPatternConfig_;
+    struct PatternConfig persistedPatternConfig_;
+    Palette::DoubleBufferedPalette palette_;
+    std::shared_ptr<Timing::Clock> clock_;
+    std::shared_ptr<Audio::AudioAnalyzer> audioAnalyzer_;
+    std::shared_ptr<Render::ColumnWorkerPool> workerPool_;
+    Timing::FrameScheduler frameScheduler_;
     std::atomic_bool stopShowLoop_{false};
+    std::atomic_bool isSelfTestRequested_{false};
     std::thread showLoopThread_;
+    Sequencer::CueListPlayer cueListPlayer_;
+    std::atomic<CueListCommand> cueListCommand_{CueListCommand::NONE};
+    // Parameter cues dispatched since the last perform, only accessed by the show loop
+    std::vector<Sequencer::Cue> pendingParameterCues_;
+    // Programs perform for at most 5 s, cue lists rarely hold more parameter changes in that time. More are dropped.
+    static const size_t MAX_PENDING_PARAMETER_CUE_COUNT_ = 32;
+    // Limits the memory used for receiving programs (see setupProgramRequestHandler())
+    static const size_t MAX_PROGRAM_SIZE_ = 8192;
+    static constexpr const char *PREFERENCES_NAMESPACE_ = "ravelights";
+    // Cue lists are streamed from flash while playing, so they can be much longer than programs
+    static const size_t MAX_CUE_LIST_SIZE_ = 262144;
+    static constexpr const char *CUE_LIST_PATH_ = "/cues.txt";
+    static constexpr const char *CUE_LIST_UPLOAD_PATH_ = "/cues.tmp";
+    // The file server picks the compressed file if only that exists
+    static constexpr const char *INDEX_PATH_ = "/index.html";
+    static constexpr const char *COMPRESSED_INDEX_PATH_ = "/index.html.gz";
+    // Set before the web server is started, see setupStaticFileHandler()
+    String indexETag_;
 
     void setupFastled(const std::array<int, PIN_COUNT> &lightsPerPin) {
         // Allocate led buffer
         LIGHT_COUNT_ = std::accumulate(lightsPerPin.begin(), lightsPerPin.end(), 0);
         PIXEL_COUNT_ = LIGHT_COUNT_ * PIXELS_PER_LIGHT_;
         leds_.resize(PIXEL_COUNT_);
+        highDepthLeds_.resize(PIXEL_COUNT_);
+        quantizer_.init(PIXEL_COUNT_);
         // We can't use a loop here since addLeds() template parameters must be known at
         // compile-time
         int pixelOffset = 0;
@@ -124,19 +292,161 @@ template <int PIN_COUNT, const std::array<int, PIN_COUNT> &PINS, EOrder RGB_ORDE
 
     void updatePatternConfig() {
         currentPatternConfig_ = nextPatternConfig_;
-        FastLED.setBrightness(currentPatternConfig_.brightness);
+        // The 16 bit led buffer is dimmed and dithered by the quantizer, which keeps the precision that FastLED's
+        // brightness scaling would lose
+        if (patterns_[currentPatternConfig_.patternIndex]->usesHighDepthBuffer()) {
+            quantizer_.setBrightness(currentPatternConfig_.brightness);
+            FastLED.setBrightness(255);
+            FastLED.setDither(DISABLE_DITHER);
+        } else {
+            FastLED.setBrightness(currentPatternConfig_.brightness);
+            FastLED.setDither(BINARY_DITHER);
+        }
+    }
+
+    // Same as a request to /pattern, the show loop switches to the pattern as soon as it's waiting for the next perform
+    void requestPatternChange(unsigned patternIndex) {
+        nextPatternConfig_.patternIndex = patternIndex;
+        std::lock_guard<std::mutex> lockGuard(isPatternUpdatePendingMutex_);
+        isPatternUpdatePending_ = true;
+        // Long performs, e.g. of programs, return early
+        frameScheduler_.requestInterrupt();
+    }
+
+    // Called by the show loop, with every frame and while waiting for the next perform
+    void updateCueList() {
+        switch (cueListCommand_.exchange(CueListCommand::NONE)) {
+        case CueListCommand::START:
+            if (cueListPlayer_.start(LittleFS, CUE_LIST_PATH_, clock_->nowUs())) {
+                Serial.println("Cue list started");
+            } else {
+                Serial.println("Error. Could not open cue list");
+            }
+            break;
+        case CueListCommand::STOP:
+            cueListPlayer_.stop();
+            break;
+        case CueListCommand::NONE:
+            break;
+        }
+        cueListPlayer_.advance(clock_->nowUs());
+    }
+
+    void dispatchCue(const Sequencer::Cue &cue) {
+        switch (cue.type) {
+        case Sequencer::CueType::PATTERN:
+            if (cue.value < patterns_.size()) {
+                requestPatternChange(cue.value);
+            } else {
+                Serial.printf("Error. Cue for invalid pattern #%u\n", cue.value);
+            }
+            break;
+        case Sequencer::CueType::COLOR:
+            nextPatternConfig_.color = cue.value;
+            break;
+        case Sequencer::CueType::BRIGHTNESS:
+            nextPatternConfig_.brightness = cue.value;
+            break;
+        case Sequencer::CueType::PARAMETER:
+            // Patterns only take parameters between two performs, and the cue may fire in the middle of one
+            if (pendingParameterCues_.size() < MAX_PENDING_PARAMETER_CUE_COUNT_) {
+                pendingParameterCues_.push_back(cue);
+            } else {
+                Serial.printf("Error. Too many parameter cues at once, dropped %s of pattern #%u\n", cue.parameterName,
+                              cue.value);
+            }
+            break;
+        case Sequencer::CueType::BLACKOUT: {
+            auto blackout = std::find_if(patterns_.begin(), patterns_.end(),
+                                         [](const std::shared_ptr<Pattern::AbstractPattern> &pattern) {
+                                             return pattern->isBlackout();
+                                         });
+            if (blackout != patterns_.end()) {
+                requestPatternChange(blackout - patterns_.begin());
+            } else {
+                Serial.println("Error. Blackout cue, but no Blackout pattern has been added");
+            }
+            break;
+        }
+        case Sequencer::CueType::LOOP:
+            // Handled by the player
+            break;
+        }
+    }
+
+    // Called by the show loop between two performs
+    void applyPendingParameterCues() {
+        for (const Sequencer::Cue &cue : pendingParameterCues_) {
+            if (cue.value >= patterns_.size() ||
+                !patterns_[cue.value]->setParameter(cue.parameterName, cue.parameterValue)) {
+                Serial.printf("Error. Could not set parameter %s of pattern #%u\n", cue.parameterName, cue.value);
+            }
+        }
+        pendingParameterCues_.clear();
     }
 
     void setupRequestHandlers() {
-        server_.on("/", HTTP_GET, [](AsyncWebServerRequest *request) {
-            request->send_P(200, "text/html", "Documentation in process...");
-        });
         setupPatternRequestHandler();
         setupBrightnessRequestHandler();
         setupColorRequestHandler();
+        setupPaletteRequestHandler();
+        setupTimingRequestHandler();
+        setupProgramRequestHandler();
+        setupCueListRequestHandler();
+        // Live preview of the shown frames at ws://<address>/preview
+        server_.addHandler(&preview_.getWebSocket());
+        setupStaticFileHandler();
+    }
+
+    void setupStaticFileHandler() {
+        // Assets are stored as precompressed "<file>.gz" (see scripts/compress_web_assets.py) and streamed from flash
+        // with "Content-Encoding: gzip". The static file handler would use the file size as ETag, so a re-uploaded
+        // control UI of the same size would be served stale from the browser cache. Instead, browsers revalidate it on
+        // every load against an ETag of its content and get "304 Not Modified" if it is unchanged.
+        server_.on("/", HTTP_GET, [this](AsyncWebServerRequest *request) {
+            if (indexETag_.length() == 0) {
+                request->send_P(200, "text/plain",
+                                "Control UI not found. Upload it using `pio run --target uploadfs`.");
+                return;
+            }
+            if (request->header("If-None-Match") == indexETag_) {
+                request->send(304);
+                return;
+            }
+            AsyncWebServerResponse *response = request->beginResponse(LittleFS, INDEX_PATH_, "text/html");
+            response->addHeader("Cache-Control", "no-cache");
+            response->addHeader("ETag", indexETag_);
+            request->send(response);
+        });
+        // Without Cache-Control, the handler neither sends nor checks ETags. Registered last so that requests to the
+        // handlers above don't cause filesystem lookups.
+        server_.serveStatic("/", LittleFS, "/");
+    }
+
+    // Quoted FNV-1a hash of the compressed control UI, or "" if it has not been uploaded
+    static String hashFileForETag(const char *path) {
+        File file = LittleFS.open(path, "r");
+        if (!file) {
+            return "";
+        }
+        uint32_t hash = 2166136261u;
+        uint8_t buffer[256];
+        size_t length;
+        while ((length = file.read(buffer, sizeof(buffer))) > 0) {
+            for (size_t i = 0; i < length; i++) {
+                hash = (hash ^ buffer[i]) * 16777619u;
+            }
+        }
+        file.close();
+        char eTag[11];
+        snprintf(eTag, sizeof(eTag), "\"%08x\"", hash);
+        return eTag;
     }
 
     void setupPatternRequestHandler() {
+        server_.on("/patterns", HTTP_GET, [this](AsyncWebServerRequest *request) {
+            request->send(200, "text/plain", String(patterns_.size()));
+        });
         server_.on("/pattern", HTTP_GET, [this](AsyncWebServerRequest *request) {
             bool hasError = false;
             int patternIndex = 0;
@@ -151,12 +461,8 @@ template <int PIN_COUNT, const std::array<int, PIN_COUNT> &PINS, EOrder RGB_ORDE
             if (hasError) {
                 request->send(200, "text/plain", "Error. Could not update pattern to #" + String(patternIndex));
             } else {
-                nextPatternConfig_.patternIndex = patternIndex;
                 request->send(200, "text/plain", "OK. Pattern Updated to #" + String(patternIndex));
-                {
-                    std::lock_guard<std::mutex> lockGuard(isPatternUpdatePendingMutex_);
-                    isPatternUpdatePending_ = true;
-                }
+                requestPatternChange(patternIndex);
             }
         });
     }
@@ -203,4 +509,156 @@ template <int PIN_COUNT, const std::array<int, PIN_COUNT> &PINS, EOrder RGB_ORDE
             }
         });
     }
+
+    void setupPaletteRequestHandler() {
+        // /palette?gradient=<rrggbb>,<rrggbb>,... with evenly spaced color stops
+        // /palette?hue=<0-255>&range=<0-255>[&saturation=<0-255>][&value=<0-255>] for a sweep along the color wheel
+        // /palette?off to use the plain color again
+        server_.on("/palette", HTTP_GET, [this](AsyncWebServerRequest *request) {
+            bool hasError = false;
+            if (request->hasParam("gradient")) {
+                std::string colorStops = request->getParam("gradient")->value().c_str();
+                hasError = !palette_.update(
+                    [&colorStops](Palette::Lut &lut) { return Palette::fillFromGradient(lut, colorStops); });
+            } else if (request->hasParam("hue") && request->hasParam("range")) {
+                int hue = request->getParam("hue")->value().toInt();
+                int range = request->getParam("range")->value().toInt();
+                int saturation = 255;
+                if (request->hasParam("saturation")) {
+                    saturation = request->getParam("saturation")->value().toInt();
+                }
+                int value = 255;
+                if (request->hasParam("value")) {
+                    value = request->getParam("value")->value().toInt();
+                }
+                for (int parameter : {hue, range, saturation, value}) {
+                    if (parameter < 0 || parameter > 255) {
+                        hasError = true;
+                    }
+                }
+                if (!hasError) {
+                    palette_.update([&](Palette::Lut &lut) {
+                        Palette::fillFromHsvSweep(lut, hue, range, saturation, value);
+                        return true;
+                    });
+                }
+            } else if (request->hasParam("off")) {
+                palette_.disable();
+            } else {
+                hasError = true;
+            }
+            if (hasError) {
+                request->send(200, "text/plain", "Error. Could not update palette");
+            } else {
+                request->send(200, "text/plain", "OK. Palette updated");
+            }
+        });
+    }
+
+    void setupTimingRequestHandler() {
+        // /timing?reset clears the statistics after returning them, e.g. before starting a measurement
+        server_.on("/timing", HTTP_GET, [this](AsyncWebServerRequest *request) {
+            request->send(200, "text/plain", (frameScheduler_.getStatistics() + preview_.getStatistics()).c_str());
+            if (request->hasParam("reset")) {
+                frameScheduler_.resetStatistics();
+            }
+        });
+    }
+
+    void setupProgramRequestHandler() {
+        // POST /program?pattern=<index> with the source of a program in the pattern language as body
+        server_.on(
+            "/program", HTTP_POST,
+            [this](AsyncWebServerRequest *request) {
+                int patternIndex = -1;
+                if (request->hasParam("pattern")) {
+                    patternIndex = request->getParam("pattern")->value().toInt();
+                }
+                if (patternIndex < 0 || patternIndex >= patterns_.size()) {
+                    request->send(200, "text/plain", "Error. Invalid pattern #" + String(patternIndex));
+                    return;
+                }
+                if (!request->_tempObject) {
+                    request->send(200, "text/plain", "Error. Program is empty or too long");
+                    return;
+                }
+                std::string error;
+                if (patterns_[patternIndex]->loadProgram(static_cast<const char *>(request->_tempObject), error)) {
+                    request->send(200, "text/plain", "OK. Program loaded into pattern #" + String(patternIndex));
+                } else {
+                    request->send(200, "text/plain", ("Error. " + error).c_str());
+                }
+            },
+            nullptr,
+            [](AsyncWebServerRequest *request, uint8_t *data, size_t length, size_t index, size_t total) {
+                // The body arrives in chunks, it is collected in a buffer that is freed together with the request
+                if (total > MAX_PROGRAM_SIZE_) {
+                    return;
+                }
+                if (index == 0) {
+                    request->_tempObject = malloc(total + 1);
+                    if (!request->_tempObject) {
+                        return;
+                    }
+                    static_cast<char *>(request->_tempObject)[total] = '\0';
+                }
+                if (request->_tempObject) {
+                    memcpy(static_cast<char *>(request->_tempObject) + index, data, length);
+                }
+            });
+    }
+
+    void setupCueListRequestHandler() {
+        // GET /cues returns the progress of the cue list, /cues?start plays it from its start and /cues?stop stops it
+        server_.on("/cues", HTTP_GET, [this](AsyncWebServerRequest *request) {
+            if (request->hasParam("start")) {
+                if (!LittleFS.exists(CUE_LIST_PATH_)) {
+                    request->send(200, "text/plain", "Error. No cue list has been uploaded");
+                    return;
+                }
+                startCueList();
+                request->send(200, "text/plain", "OK. Cue list started");
+            } else if (request->hasParam("stop")) {
+                stopCueList();
+                request->send(200, "text/plain", "OK. Cue list stopped");
+            } else {
+                request->send(200, "text/plain", cueListPlayer_.getStatus().c_str());
+            }
+        });
+        // POST /cues with a cue list (see sequencer/Cue.hpp) as body. It is written to flash in chunks as it arrives
+        // and only replaces the stored cue list once complete.
+        server_.on(
+            "/cues", HTTP_POST,
+            [this](AsyncWebServerRequest *request) {
+                if (request->contentLength() > MAX_CUE_LIST_SIZE_) {
+                    request->send(200, "text/plain", "Error. Cue list is too long");
+                    return;
+                }
+                File file = LittleFS.open(CUE_LIST_UPLOAD_PATH_, "r");
+                const bool isComplete = file && file.size() == request->contentLength();
+                file.close();
+                // The player reads the stored cue list while playing
+                if (!isComplete || cueListPlayer_.isRunning()) {
+                    LittleFS.remove(CUE_LIST_UPLOAD_PATH_);
+                    request->send(200, "text/plain",
+                                  isComplete ? "Error. Stop the cue list before uploading a new one"
+                                             : "Error. Could not store cue list");
+                    return;
+                }
+                LittleFS.remove(CUE_LIST_PATH_);
+                LittleFS.rename(CUE_LIST_UPLOAD_PATH_, CUE_LIST_PATH_);
+                request->send(200, "text/plain", "OK. Cue list uploaded, start it with /cues?start");
+            },
+            nullptr,
+            [](AsyncWebServerRequest *request, uint8_t *data, size_t length, size_t index, size_t total) {
+                if (total > MAX_CUE_LIST_SIZE_) {
+                    return;
+                }
+                File file = LittleFS.open(CUE_LIST_UPLOAD_PATH_, index == 0 ? "w" : "a");
+                if (file) {
+                    file.write(data, length);
+                    file.close();
+                }
+            });
+    }
 };
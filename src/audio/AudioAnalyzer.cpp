@@ -0,0 +1,99 @@
+#include "audio/AudioAnalyzer.hpp"
+
+#include <Arduino.h>
+#include <algorithm>
+#include <cmath>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+namespace Audio {
+// Upper frequency limit of each band in Hz, the last band extends to the Nyquist frequency
+const std::array<unsigned, AudioFeatures::BAND_COUNT - 1> BAND_LIMITS_HZ = {60, 250, 500, 2000, 4000};
+// Band peaks decay by this factor per hop, i.e. within a few seconds
+const float PEAK_DECAY = 0.995;
+// Peaks don't fall below this, so that silence isn't amplified to full levels
+const float MIN_PEAK = 1000;
+// An onset is detected if the rise in bass energy exceeds its running average by this factor
+const float ONSET_THRESHOLD = 2.5;
+// Minimum number of hops between two onsets (~100 ms at 22050 Hz)
+const unsigned ONSET_REFRACTORY_HOPS = 9;
+
+AudioAnalyzer::AudioAnalyzer(std::shared_ptr<AudioSource> source) : source_(source) {
+    for (unsigned i = 0; i < FixedPointFft::SIZE; i++) {
+        window_[i] = std::lround(32767 * 0.5 * (1 - std::cos(2 * M_PI * i / (FixedPointFft::SIZE - 1))));
+    }
+    const float binWidthHz = (float)source_->getSampleRate() / FixedPointFft::SIZE;
+    // Skip the DC bin
+    bandStartBins_[0] = 1;
+    for (unsigned band = 0; band < BAND_LIMITS_HZ.size(); band++) {
+        unsigned bin = std::lround(BAND_LIMITS_HZ[band] / binWidthHz);
+        bandStartBins_[band + 1] = constrain(bin, bandStartBins_[band] + 1, FixedPointFft::SIZE / 2);
+    }
+    bandStartBins_.back() = FixedPointFft::SIZE / 2;
+}
+
+void AudioAnalyzer::start(int core) {
+    source_->begin();
+    {
+        std::lock_guard<std::mutex> lockGuard(featuresMutex_);
+        features_.isActive = true;
+    }
+    xTaskCreatePinnedToCore(&AudioAnalyzer::runTask, "audio", 4096, this, 1, nullptr, core);
+}
+
+void AudioAnalyzer::runTask(void *analyzer) {
+    auto *self = static_cast<AudioAnalyzer *>(analyzer);
+    std::array<int16_t, HOP_SIZE> hop;
+    while (true) {
+        self->source_->read(hop.data(), hop.size());
+        self->processHop(hop.data());
+    }
+}
+
+void AudioAnalyzer::processHop(const int16_t *samples) {
+    // Slide the window by one hop
+    std::copy(samples_.begin() + HOP_SIZE, samples_.end(), samples_.begin());
+    std::copy(samples, samples + HOP_SIZE, samples_.end() - HOP_SIZE);
+    for (unsigned i = 0; i < FixedPointFft::SIZE; i++) {
+        real_[i] = ((int32_t)samples_[i] * window_[i]) >> 15;
+        imaginary_[i] = 0;
+    }
+    fft_.transform(real_, imaginary_);
+
+    std::array<float, AudioFeatures::BAND_COUNT> bandEnergies;
+    for (unsigned band = 0; band < AudioFeatures::BAND_COUNT; band++) {
+        uint64_t energy = 0;
+        for (unsigned bin = bandStartBins_[band]; bin < bandStartBins_[band + 1]; bin++) {
+            energy += (int32_t)real_[bin] * real_[bin] + (int32_t)imaginary_[bin] * imaginary_[bin];
+        }
+        bandEnergies[band] = energy;
+    }
+
+    // Onsets are rises in bass energy that stand out from the recent average rise
+    float bassEnergy = bandEnergies[AudioFeatures::SUB_BASS] + bandEnergies[AudioFeatures::BASS];
+    float bassFlux = max(0.0f, bassEnergy - previousBassEnergy_);
+    previousBassEnergy_ = bassEnergy;
+    bool isOnset = hopsSinceOnset_ >= ONSET_REFRACTORY_HOPS && bassFlux > ONSET_THRESHOLD * averageBassFlux_ &&
+                   bassEnergy > MIN_PEAK;
+    averageBassFlux_ = 0.9f * averageBassFlux_ + 0.1f * bassFlux;
+    hopsSinceOnset_ = isOnset ? 0 : hopsSinceOnset_ + 1;
+
+    std::array<uint8_t, AudioFeatures::BAND_COUNT> bandLevels;
+    for (unsigned band = 0; band < AudioFeatures::BAND_COUNT; band++) {
+        bandPeaks_[band] = max(max(bandEnergies[band], bandPeaks_[band] * PEAK_DECAY), MIN_PEAK);
+        // Amplitude rather than energy, which is closer to perceived loudness
+        bandLevels[band] = 255 * std::sqrt(bandEnergies[band] / bandPeaks_[band]);
+    }
+
+    std::lock_guard<std::mutex> lockGuard(featuresMutex_);
+    features_.bandLevels = bandLevels;
+    if (isOnset) {
+        features_.onsetCount++;
+    }
+}
+
+AudioFeatures AudioAnalyzer::getFeatures() {
+    std::lock_guard<std::mutex> lockGuard(featuresMutex_);
+    return features_;
+}
+};  // namespace Audio
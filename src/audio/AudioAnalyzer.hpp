@@ -0,0 +1,57 @@
+#pragma once
+
+#include "audio/AudioSource.hpp"
+#include "audio/FixedPointFft.hpp"
+#include <array>
+#include <memory>
+#include <mutex>
+
+namespace Audio {
+// Per-frame summary of the music, as seen by patterns
+struct AudioFeatures {
+    static const unsigned BAND_COUNT = 6;
+    enum Band { SUB_BASS, BASS, LOW_MIDS, MIDS, HIGH_MIDS, HIGHS };
+
+    bool isActive{false};
+    // Loudness of each band relative to its recent peak (0 - 255)
+    std::array<uint8_t, BAND_COUNT> bandLevels{};
+    // Incremented on every detected onset in the bass bands, i.e. on kicks
+    uint32_t onsetCount{0};
+};
+
+// Splits a PCM stream into half-overlapping windows, runs a fixed point FFT on each of them and extracts band levels
+// and onsets. Runs as a task on its own core and never allocates after construction.
+class AudioAnalyzer {
+   public:
+    explicit AudioAnalyzer(std::shared_ptr<AudioSource> source);
+    // Starts analyzing on the given core. Use the core that the show loop is not running on.
+    void start(int core = 0);
+    // Analyzes the next HOP_SIZE samples. Called by the analysis task, but can also be fed directly from a recording.
+    void processHop(const int16_t *samples);
+    // May be called from any thread
+    AudioFeatures getFeatures();
+
+    static const unsigned HOP_SIZE = FixedPointFft::SIZE / 2;
+
+   private:
+    std::shared_ptr<AudioSource> source_;
+    FixedPointFft fft_;
+    // Hann window in Q15
+    std::array<int16_t, FixedPointFft::SIZE> window_;
+    // The last FixedPointFft::SIZE samples
+    std::array<int16_t, FixedPointFft::SIZE> samples_{};
+    std::array<int16_t, FixedPointFft::SIZE> real_;
+    std::array<int16_t, FixedPointFft::SIZE> imaginary_;
+    // First FFT bin of each band, the last entry is one past the last bin of the last band
+    std::array<unsigned, AudioFeatures::BAND_COUNT + 1> bandStartBins_;
+    std::array<float, AudioFeatures::BAND_COUNT> bandPeaks_{};
+    float previousBassEnergy_{0};
+    float averageBassFlux_{0};
+    unsigned hopsSinceOnset_{0};
+
+    AudioFeatures features_;
+    std::mutex featuresMutex_;
+
+    static void runTask(void *analyzer);
+};
+};  // namespace Audio
@@ -0,0 +1,69 @@
+#include "audio/AudioSource.hpp"
+
+#include <Arduino.h>
+#include <driver/i2s.h>
+
+namespace Audio {
+// FastLED's parallel output driver occupies I2S0
+const i2s_port_t I2S_PORT = I2S_NUM_1;
+
+void I2sAudioSource::begin() {
+    i2s_config_t config = {};
+    config.mode = (i2s_mode_t)(I2S_MODE_MASTER | I2S_MODE_RX);
+    config.sample_rate = SAMPLE_RATE_;
+    config.bits_per_sample = I2S_BITS_PER_SAMPLE_32BIT;
+    config.channel_format = I2S_CHANNEL_FMT_ONLY_LEFT;
+    config.communication_format = I2S_COMM_FORMAT_STAND_I2S;
+    config.intr_alloc_flags = ESP_INTR_FLAG_LEVEL1;
+    config.dma_buf_count = 4;
+    config.dma_buf_len = rawSamples_.size();
+    config.use_apll = false;
+    i2s_pin_config_t pins = {};
+    pins.bck_io_num = BIT_CLOCK_PIN_;
+    pins.ws_io_num = WORD_SELECT_PIN_;
+    pins.data_out_num = I2S_PIN_NO_CHANGE;
+    pins.data_in_num = DATA_PIN_;
+    if (i2s_driver_install(I2S_PORT, &config, 0, nullptr) != ESP_OK || i2s_set_pin(I2S_PORT, &pins) != ESP_OK) {
+        Serial.println("Error. Could not set up I2S audio input.");
+    }
+}
+
+void I2sAudioSource::read(int16_t *samples, size_t count) {
+    while (count > 0) {
+        size_t bytesRead = 0;
+        size_t samplesToRead = min(count, rawSamples_.size());
+        i2s_read(I2S_PORT, rawSamples_.data(), samplesToRead * sizeof(int32_t), &bytesRead, portMAX_DELAY);
+        size_t samplesRead = bytesRead / sizeof(int32_t);
+        for (size_t i = 0; i < samplesRead; i++) {
+            // The 24 significant bits are left aligned. Keep some headroom instead of using the upper 16 bits only,
+            // since microphones rarely reach full scale.
+            samples[i] = constrain(rawSamples_[i] >> 14, INT16_MIN, INT16_MAX);
+        }
+        samples += samplesRead;
+        count -= samplesRead;
+    }
+}
+
+void UdpAudioSource::begin() { udp_.begin(PORT_); }
+
+void UdpAudioSource::read(int16_t *samples, size_t count) {
+    while (count > 0) {
+        if (packetOffset_ + 1 >= packetSize_) {
+            int packetSize = udp_.parsePacket();
+            if (packetSize <= 0) {
+                delay(1);
+                continue;
+            }
+            // read() returns -1 on errors, which must not become a huge size
+            int bytesRead = udp_.read(packet_.data(), packet_.size());
+            packetSize_ = bytesRead > 0 ? bytesRead : 0;
+            packetOffset_ = 0;
+        }
+        while (count > 0 && packetOffset_ + 1 < packetSize_) {
+            *samples++ = (int16_t)(packet_[packetOffset_] | (packet_[packetOffset_ + 1] << 8));
+            packetOffset_ += 2;
+            count--;
+        }
+    }
+}
+};  // namespace Audio
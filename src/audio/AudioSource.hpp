@@ -0,0 +1,54 @@
+#pragma once
+
+#include <WiFiUdp.h>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace Audio {
+// Stream of mono 16 bit PCM samples
+class AudioSource {
+   public:
+    virtual ~AudioSource(){};
+    virtual void begin() = 0;
+    // Blocks until count samples have been read
+    virtual void read(int16_t *samples, size_t count) = 0;
+    virtual unsigned getSampleRate() const = 0;
+};
+
+// I2S MEMS microphone such as the INMP441, which sends 24 bit samples in 32 bit frames on the left channel
+class I2sAudioSource : public AudioSource {
+   public:
+    I2sAudioSource(int bitClockPin, int wordSelectPin, int dataPin, unsigned sampleRate = 22050)
+        : BIT_CLOCK_PIN_(bitClockPin), WORD_SELECT_PIN_(wordSelectPin), DATA_PIN_(dataPin), SAMPLE_RATE_(sampleRate){};
+    void begin() override;
+    void read(int16_t *samples, size_t count) override;
+    unsigned getSampleRate() const override { return SAMPLE_RATE_; }
+
+   private:
+    const int BIT_CLOCK_PIN_;
+    const int WORD_SELECT_PIN_;
+    const int DATA_PIN_;
+    const unsigned SAMPLE_RATE_;
+    std::array<int32_t, 128> rawSamples_;
+};
+
+// Raw little endian 16 bit PCM sent as UDP datagrams, e.g. from a mixing desk computer:
+// ffmpeg -i <input> -f s16le -ac 1 -ar 22050 udp://192.168.4.1:<port>?pkt_size=1024
+class UdpAudioSource : public AudioSource {
+   public:
+    UdpAudioSource(uint16_t port, unsigned sampleRate = 22050) : PORT_(port), SAMPLE_RATE_(sampleRate){};
+    void begin() override;
+    void read(int16_t *samples, size_t count) override;
+    unsigned getSampleRate() const override { return SAMPLE_RATE_; }
+
+   private:
+    const uint16_t PORT_;
+    const unsigned SAMPLE_RATE_;
+    WiFiUDP udp_;
+    // Remainder of the last datagram that didn't fit into the previous read()
+    std::array<uint8_t, 1472> packet_;
+    size_t packetSize_{0};
+    size_t packetOffset_{0};
+};
+};  // namespace Audio
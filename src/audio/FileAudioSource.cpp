@@ -0,0 +1,107 @@
+#include "audio/FileAudioSource.hpp"
+
+#include <Arduino.h>
+#include <algorithm>
+#include <cstring>
+
+namespace Audio {
+namespace {
+const uint16_t PCM_FORMAT = 1;
+
+inline uint16_t readUint16(const uint8_t *bytes) { return bytes[0] | (bytes[1] << 8); }
+inline uint32_t readUint32(const uint8_t *bytes) { return readUint16(bytes) | ((uint32_t)readUint16(bytes + 2) << 16); }
+}  // namespace
+
+FileAudioSource::FileAudioSource(fs::FS &fs, const char *path, bool isRealTime) : IS_REAL_TIME_(isRealTime) {
+    file_ = fs.open(path, "r");
+    if (!file_ || !readHeader()) {
+        Serial.printf("Error. %s is not a mono 16 bit PCM WAV file, playing silence\n", path);
+        dataSize_ = 0;
+    }
+}
+
+void FileAudioSource::begin() {
+    startMs_ = millis();
+    readSampleCount_ = 0;
+}
+
+void FileAudioSource::read(int16_t *samples, size_t count) {
+    if (IS_REAL_TIME_) {
+        // Wait until the last requested sample would have been recorded
+        readSampleCount_ += count;
+        const unsigned long dueMs = startMs_ + readSampleCount_ * 1000 / sampleRate_;
+        const long waitMs = (long)(dueMs - millis());
+        if (waitMs > 0) {
+            delay(waitMs);
+        }
+    }
+    if (!isValid()) {
+        std::fill(samples, samples + count, 0);
+        return;
+    }
+    while (count > 0) {
+        if (dataPosition_ + 1 >= dataSize_) {
+            file_.seek(dataStart_);
+            dataPosition_ = 0;
+        }
+        const size_t byteCount = std::min({count * 2, buffer_.size(), (size_t)(dataSize_ - dataPosition_)});
+        const size_t bytesRead = file_.read(buffer_.data(), byteCount) & ~(size_t)1;
+        if (bytesRead == 0) {
+            if (dataPosition_ == 0) {
+                // The header promised samples that aren't there
+                dataSize_ = 0;
+                std::fill(samples, samples + count, 0);
+                return;
+            }
+            // Truncated file, start over
+            dataPosition_ = dataSize_;
+            continue;
+        }
+        for (size_t i = 0; i < bytesRead; i += 2) {
+            *samples++ = (int16_t)readUint16(&buffer_[i]);
+        }
+        dataPosition_ += bytesRead;
+        count -= bytesRead / 2;
+    }
+}
+
+// Skips chunks other than "fmt " and "data", returns false unless the format is mono 16 bit PCM
+bool FileAudioSource::readHeader() {
+    uint8_t header[12];
+    if (file_.read(header, sizeof(header)) != sizeof(header) || memcmp(header, "RIFF", 4) != 0 ||
+        memcmp(header + 8, "WAVE", 4) != 0) {
+        return false;
+    }
+    bool hasFormat = false;
+    uint32_t position = sizeof(header);
+    while (true) {
+        uint8_t chunkHeader[8];
+        if (file_.read(chunkHeader, sizeof(chunkHeader)) != sizeof(chunkHeader)) {
+            return false;
+        }
+        const uint32_t chunkSize = readUint32(chunkHeader + 4);
+        position += sizeof(chunkHeader);
+        if (memcmp(chunkHeader, "fmt ", 4) == 0) {
+            uint8_t format[16];
+            if (chunkSize < sizeof(format) || file_.read(format, sizeof(format)) != sizeof(format)) {
+                return false;
+            }
+            // Format tag, channel count, sample rate, byte rate, block size and bits per sample
+            if (readUint16(format) != PCM_FORMAT || readUint16(format + 2) != 1 || readUint16(format + 14) != 16) {
+                return false;
+            }
+            sampleRate_ = readUint32(format + 4);
+            hasFormat = sampleRate_ > 0;
+        } else if (memcmp(chunkHeader, "data", 4) == 0) {
+            dataStart_ = position;
+            dataSize_ = chunkSize & ~1u;
+            return hasFormat && dataSize_ > 0;
+        }
+        // Chunks are padded to an even size
+        position += chunkSize + (chunkSize & 1);
+        if (!file_.seek(position)) {
+            return false;
+        }
+    }
+}
+};  // namespace Audio
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "FS.h"
+#include "audio/AudioSource.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace Audio {
+// Mono 16 bit PCM WAV file, e.g. a recording on LittleFS for rehearsing without a microphone, or a test signal on the
+// host. Starts over at the end of the file. Files in other formats are reported on the serial port and play silence.
+class FileAudioSource : public AudioSource {
+   public:
+    // Reads the header right away, so that the sample rate is known before the analyzer is constructed.
+    // With isRealTime, read() waits so that samples arrive at the sample rate like from a microphone, otherwise it
+    // returns as fast as the file can be read, e.g. for tests and benchmarks.
+    FileAudioSource(fs::FS &fs, const char *path, bool isRealTime = true);
+    void begin() override;
+    void read(int16_t *samples, size_t count) override;
+    unsigned getSampleRate() const override { return sampleRate_; }
+    bool isValid() const { return dataSize_ > 0; }
+
+   private:
+    const bool IS_REAL_TIME_;
+    fs::File file_;
+    unsigned sampleRate_{22050};
+    // Byte range of the samples in the file
+    uint32_t dataStart_{0};
+    uint32_t dataSize_{0};
+    uint32_t dataPosition_{0};
+    std::array<uint8_t, 256> buffer_;
+    // Time at which the first sample has been read and the samples read since, to pace real time reads
+    unsigned long startMs_{0};
+    uint64_t readSampleCount_{0};
+
+    bool readHeader();
+};
+};  // namespace Audio
@@ -0,0 +1,44 @@
+#include "audio/FixedPointFft.hpp"
+
+#include <cmath>
+#include <utility>
+
+namespace Audio {
+FixedPointFft::FixedPointFft() {
+    for (unsigned i = 0; i < SIZE; i++) {
+        sineTable_[i] = std::lround(std::sin(2 * M_PI * i / SIZE) * 32767);
+        unsigned reversed = 0;
+        for (unsigned bit = 0; bit < LOG2_SIZE; bit++) {
+            reversed |= ((i >> bit) & 1) << (LOG2_SIZE - 1 - bit);
+        }
+        bitReversedIndices_[i] = reversed;
+    }
+}
+
+void FixedPointFft::transform(std::array<int16_t, SIZE> &real, std::array<int16_t, SIZE> &imaginary) const {
+    for (unsigned i = 0; i < SIZE; i++) {
+        unsigned j = bitReversedIndices_[i];
+        if (i < j) {
+            std::swap(real[i], real[j]);
+            std::swap(imaginary[i], imaginary[j]);
+        }
+    }
+    for (unsigned halfSize = 1; halfSize < SIZE; halfSize *= 2) {
+        const unsigned twiddleStep = SIZE / (2 * halfSize);
+        for (unsigned k = 0; k < halfSize; k++) {
+            // e^(-2 * pi * i * k / (2 * halfSize)), cos(x) = sin(x + pi / 2)
+            const int32_t twiddleReal = sineTable_[(k * twiddleStep + SIZE / 4) % SIZE];
+            const int32_t twiddleImaginary = -sineTable_[k * twiddleStep];
+            for (unsigned i = k; i < SIZE; i += 2 * halfSize) {
+                const unsigned j = i + halfSize;
+                const int32_t productReal = (twiddleReal * real[j] - twiddleImaginary * imaginary[j]) >> 15;
+                const int32_t productImaginary = (twiddleReal * imaginary[j] + twiddleImaginary * real[j]) >> 15;
+                real[j] = (real[i] - productReal) >> 1;
+                imaginary[j] = (imaginary[i] - productImaginary) >> 1;
+                real[i] = (real[i] + productReal) >> 1;
+                imaginary[i] = (imaginary[i] + productImaginary) >> 1;
+            }
+        }
+    }
+}
+};  // namespace Audio
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace Audio {
+// In-place radix-2 FFT on Q15 fixed point samples. Twiddle factors and the bit reversal permutation are computed once
+// in the constructor, transform() doesn't allocate. Every stage scales by 1/2 to avoid overflow, so the result is
+// scaled by 1 / SIZE.
+class FixedPointFft {
+   public:
+    static const unsigned LOG2_SIZE = 9;
+    static const unsigned SIZE = 1 << LOG2_SIZE;
+
+    FixedPointFft();
+    void transform(std::array<int16_t, SIZE> &real, std::array<int16_t, SIZE> &imaginary) const;
+
+   private:
+    // sin(2 * pi * i / SIZE) in Q15
+    std::array<int16_t, SIZE> sineTable_;
+    std::array<uint16_t, SIZE> bitReversedIndices_;
+};
+};  // namespace Audio
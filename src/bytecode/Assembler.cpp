@@ -0,0 +1,173 @@
+#include "bytecode/Assembler.hpp"
+
+#include "bytecode/Opcodes.hpp"
+#include <cctype>
+#include <cstdlib>
+#include <map>
+#include <sstream>
+
+namespace Bytecode {
+namespace {
+struct InstructionFormat {
+    const char *mnemonic;
+    Opcode opcode;
+    // One character per operand: R = register, I = immediate, L = label
+    const char *operands;
+};
+
+const InstructionFormat INSTRUCTION_FORMATS[] = {
+    {"end", END, "R"},
+    {"stop", STOP, ""},
+    {"set", SET, "RI"},
+    {"mov", MOV, "RR"},
+    {"add", ADD, "RRR"},
+    {"sub", SUB, "RRR"},
+    {"mul", MUL, "RRR"},
+    {"div", DIV, "RRR"},
+    {"mod", MOD, "RRR"},
+    {"min", MIN, "RRR"},
+    {"max", MAX, "RRR"},
+    {"addi", ADDI, "RRI"},
+    {"rand", RAND, "RR"},
+    {"jmp", JMP, "L"},
+    {"jz", JZ, "RL"},
+    {"jnz", JNZ, "RL"},
+    {"jlt", JLT, "RRL"},
+    {"rows", ROWS, "R"},
+    {"cols", COLS, "R"},
+    {"time", TIME, "R"},
+    {"color", COLOR, "R"},
+    {"basecolor", BASECOLOR, "R"},
+    {"palette", PALETTE, "R"},
+    {"scale", SCALE, "R"},
+    {"pixel", PIXEL, "RR"},
+    {"span", SPAN, "RRR"},
+    {"fillcol", FILLCOL, "R"},
+    {"fade", FADE, "R"},
+    {"fadecol", FADECOL, "RR"},
+    {"lit", LIT, "RR"},
+    {"clear", CLEAR, ""},
+    {"show", SHOW, "R"},
+};
+
+const InstructionFormat *findFormat(const std::string &mnemonic) {
+    for (const auto &format : INSTRUCTION_FORMATS) {
+        if (mnemonic == format.mnemonic) {
+            return &format;
+        }
+    }
+    return nullptr;
+}
+
+bool parseRegister(const std::string &token, uint8_t &registerIndex) {
+    if (token.size() < 2 || token[0] != 'r') {
+        return false;
+    }
+    char *end = nullptr;
+    unsigned long index = strtoul(token.c_str() + 1, &end, 10);
+    if (*end != '\0' || index >= REGISTER_COUNT) {
+        return false;
+    }
+    registerIndex = index;
+    return true;
+}
+
+bool parseImmediate(const std::string &token, int32_t &immediate) {
+    char *end = nullptr;
+    long long value = strtoll(token.c_str(), &end, 0);
+    if (token.empty() || *end != '\0' || value < INT32_MIN || value > UINT32_MAX) {
+        return false;
+    }
+    immediate = (int32_t)value;
+    return true;
+}
+}  // namespace
+
+bool assemble(const std::string &source, std::vector<uint8_t> &code, std::string &error) {
+    code.clear();
+    std::map<std::string, uint16_t> labels;
+    // Positions of jump targets that refer to labels, which are resolved once all labels are known
+    std::vector<std::pair<size_t, std::string>> unresolvedJumps;
+    std::vector<unsigned> unresolvedJumpLines;
+    std::istringstream lines(source);
+    std::string line;
+    unsigned lineNumber = 0;
+    while (std::getline(lines, line)) {
+        lineNumber++;
+        const std::string location = "line " + std::to_string(lineNumber) + ": ";
+        line = line.substr(0, line.find('#'));
+        for (auto &character : line) {
+            if (character == ',') {
+                character = ' ';
+            }
+        }
+        std::istringstream tokenStream(line);
+        std::vector<std::string> tokens;
+        std::string token;
+        while (tokenStream >> token) {
+            tokens.push_back(token);
+        }
+        if (!tokens.empty() && tokens[0].back() == ':') {
+            std::string label = tokens[0].substr(0, tokens[0].size() - 1);
+            if (label.empty() || labels.count(label)) {
+                error = location + "Invalid or duplicate label '" + label + "'";
+                return false;
+            }
+            labels[label] = code.size();
+            tokens.erase(tokens.begin());
+        }
+        if (tokens.empty()) {
+            continue;
+        }
+        const InstructionFormat *format = findFormat(tokens[0]);
+        if (!format) {
+            error = location + "Unknown instruction '" + tokens[0] + "'";
+            return false;
+        }
+        if (tokens.size() - 1 != strlen(format->operands)) {
+            error = location + "'" + tokens[0] + "' expects " + std::to_string(strlen(format->operands)) + " operands";
+            return false;
+        }
+        code.push_back(format->opcode);
+        for (unsigned i = 0; format->operands[i] != '\0'; i++) {
+            const std::string &operand = tokens[i + 1];
+            if (format->operands[i] == 'R') {
+                uint8_t registerIndex;
+                if (!parseRegister(operand, registerIndex)) {
+                    error = location + "Invalid register '" + operand + "'";
+                    return false;
+                }
+                code.push_back(registerIndex);
+            } else if (format->operands[i] == 'I') {
+                int32_t immediate;
+                if (!parseImmediate(operand, immediate)) {
+                    error = location + "Invalid number '" + operand + "'";
+                    return false;
+                }
+                const uint8_t *bytes = reinterpret_cast<const uint8_t *>(&immediate);
+                code.insert(code.end(), bytes, bytes + sizeof(immediate));
+            } else {
+                unresolvedJumps.emplace_back(code.size(), operand);
+                unresolvedJumpLines.push_back(lineNumber);
+                code.insert(code.end(), sizeof(uint16_t), 0);
+            }
+        }
+        if (code.size() > UINT16_MAX - 16) {
+            error = location + "Program is too long";
+            return false;
+        }
+    }
+    // Programs that run past their last instruction end without delay
+    code.push_back(STOP);
+    for (unsigned i = 0; i < unresolvedJumps.size(); i++) {
+        auto label = labels.find(unresolvedJumps[i].second);
+        if (label == labels.end()) {
+            error = "line " + std::to_string(unresolvedJumpLines[i]) + ": Unknown label '" +
+                    unresolvedJumps[i].second + "'";
+            return false;
+        }
+        memcpy(&code[unresolvedJumps[i].first], &label->second, sizeof(uint16_t));
+    }
+    return true;
+}
+};  // namespace Bytecode
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Bytecode {
+// Translates the textual pattern language into bytecode (see Opcodes.hpp and programs/ for examples).
+// Each line holds an optional "label:", an optional instruction with operands separated by spaces or commas, and an
+// optional "# comment". Registers are r0 - r15, immediates are decimal or 0x prefixed hexadecimal numbers.
+// Returns false and describes the problem in error if source is invalid.
+bool assemble(const std::string &source, std::vector<uint8_t> &code, std::string &error);
+};  // namespace Bytecode
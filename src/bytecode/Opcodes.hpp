@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+namespace Bytecode {
+// Each instruction is an opcode byte followed by its operands: registers take one byte, immediates four bytes
+// (little endian) and jump targets two bytes (offset from the start of the program).
+// The order must match the dispatch table in BytecodePattern::execute().
+// Arithmetic wraps around on overflow like unsigned 32 bit integers. Durations are capped, see BytecodePattern.
+enum Opcode : uint8_t {
+    END,        // rMs            End perform(), stay dark for rMs
+    STOP,       //                End perform() without delay
+    SET,        // rD imm         rD = imm
+    MOV,        // rD rS          rD = rS
+    ADD,        // rD rA rB       rD = rA + rB
+    SUB,        // rD rA rB       rD = rA - rB
+    MUL,        // rD rA rB       rD = rA * rB
+    DIV,        // rD rA rB       rD = rA / rB rounded towards 0, or 0 if rB is 0
+    MOD,        // rD rA rB       rD = rA % rB, or 0 if rB is 0
+    MIN,        // rD rA rB       rD = min(rA, rB)
+    MAX,        // rD rA rB       rD = max(rA, rB)
+    ADDI,       // rD rA imm      rD = rA + imm
+    RAND,       // rD rMax        rD = random number in [0, rMax)
+    JMP,        // label
+    JZ,         // rA label       jump if rA == 0
+    JNZ,        // rA label       jump if rA != 0
+    JLT,        // rA rB label    jump if rA < rB
+    ROWS,       // rD             rD = number of pixels per column
+    COLS,       // rD             rD = number of columns
+    TIME,       // rD             rD = current time in ms
+    COLOR,      // rRgb           draw with color 0xrrggbb
+    BASECOLOR,  // rD             rD = color selected by the user as 0xrrggbb
+    PALETTE,    // rIndex         draw with palette entry rIndex, or the user's color if there is no palette
+    SCALE,      // rAmount        scale the draw color by rAmount / 255
+    PIXEL,      // rCol rRow      draw a single pixel
+    SPAN,       // rCol rRow rLen draw rows [rRow, rRow + rLen) of a column
+    FILLCOL,    // rCol           draw a whole column
+    FADE,       // rAmount        fade all pixels by rAmount / 256
+    FADECOL,    // rCol rAmount   fade the pixels of a column by rAmount / 256
+    LIT,        // rD rCol        rD = number of lit pixels in a column
+    CLEAR,      //                turn off all pixels
+    SHOW,       // rMs            show the frame for rMs
+    OPCODE_COUNT
+};
+
+const unsigned REGISTER_COUNT = 16;
+
+inline int32_t readImmediate(const uint8_t *code) {
+    int32_t immediate;
+    memcpy(&immediate, code, sizeof(immediate));
+    return immediate;
+}
+
+// Two's complement arithmetic without the undefined behavior of signed overflow
+inline int32_t wrappingAdd(int32_t a, int32_t b) { return (int32_t)((uint32_t)a + (uint32_t)b); }
+inline int32_t wrappingSub(int32_t a, int32_t b) { return (int32_t)((uint32_t)a - (uint32_t)b); }
+inline int32_t wrappingMul(int32_t a, int32_t b) { return (int32_t)((uint32_t)a * (uint32_t)b); }
+
+inline uint16_t readJumpTarget(const uint8_t *code) {
+    uint16_t target;
+    memcpy(&target, code, sizeof(target));
+    return target;
+}
+};  // namespace Bytecode
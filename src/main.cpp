@@ -1,8 +1,11 @@
 #include "RaveLights.hpp"
+#include "audio/AudioAnalyzer.hpp"
+#include "audio/AudioSource.hpp"
 #include "network/Network.hpp"
 #include "network/WifiCredentials.hpp"
 #include "patterns/AbstractPattern.hpp"
 #include "patterns/Blackout.hpp"
+#include "patterns/BytecodePattern.hpp"
 #include "patterns/Comet.hpp"
 #include "patterns/MovingStrobe.hpp"
 #include "patterns/MultipleStrobeFlashes.hpp"
@@ -13,6 +16,10 @@
 
 #include <Arduino.h>
 #include <esp_pthread.h>
+#include <esp_system.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
 
 /* BEGIN USER CONFIG */
 // Specify the maximum number of pins to which lights are to be connected in a specific scenario.
@@ -26,6 +33,18 @@ extern constexpr std::array<int, MAX_PIN_COUNT> PINS = {19, 18, 22, 21};
 // If there are no lights connected to a specific, set lightCount to 0.
 std::array<int, MAX_PIN_COUNT> lightsPerPin = {5, 5, 0, 0};
 const EOrder RGB_ORDER = EOrder::RGB;
+// Set to true if an I2S microphone (e.g. INMP441) is connected, to make patterns follow the music.
+const bool USE_AUDIO_INPUT = false;
+// Specify the GPIO pins of the microphone: bit clock (SCK), word select (WS) and data (SD).
+const int AUDIO_BIT_CLOCK_PIN = 26;
+const int AUDIO_WORD_SELECT_PIN = 25;
+const int AUDIO_DATA_PIN = 33;
+// Number of threads on core 0 that help the show loop render columns, or 0 to render on core 1 only.
+const unsigned RENDER_WORKER_COUNT = 0;
+// Gamma correction of patterns that render at 16 bits per channel (e.g. Comet), 1 leaves their colors unchanged.
+const float OUTPUT_GAMMA = 1.0;
+// Pattern, color and brightness are saved to flash at most this often and restored after a reset.
+const unsigned long CONFIG_PERSIST_INTERVAL_MS = 5000;
 /* END USER CONFIG */
 
 // Vector of shared_ptr's to Pattern Instances that will be added to the RaveLights instance
@@ -38,44 +57,98 @@ std::vector<std::shared_ptr<Pattern::AbstractPattern>> patterns{
     std::make_shared<Pattern::Comet>(),                  // 5
     std::make_shared<Pattern::MovingStrobe>(),           // 6
     std::make_shared<Pattern::MovingStrobe>(0.7, 0.8),   // 7
-    std::make_shared<Pattern::Blackout>()                // 8
+    std::make_shared<Pattern::Blackout>(),               // 8
+    // Stays dark until a program is uploaded to /program?pattern=9
+    std::make_shared<Pattern::BytecodePattern>()         // 9
 };
 
+typedef RaveLights<MAX_PIN_COUNT, PINS, RGB_ORDER> RaveLightsInstance;
+// Only set if USE_AUDIO_INPUT is true
+std::shared_ptr<Audio::AudioAnalyzer> audioAnalyzer;
+
+// Logs the time since boot, e.g. to measure how long the rig stays dark after a reset
+void logBootPhase(const char *phase) { Serial.printf("[%lld ms] %s\n", esp_timer_get_time() / 1000, phase); }
+
+// Brings up everything that isn't needed for the first frame. Runs on core 0, because the show loop on core 1 has a
+// higher priority and would starve it.
+void runBackgroundSetup(void *raveLightsPointer) {
+    auto &raveLights = *static_cast<RaveLightsInstance *>(raveLightsPointer);
+    Network::initWifiAccessPoint(WifiCredentials::ssid, WifiCredentials::password);
+    // Network::connectToWifi(WifiCredentials::ssid, WifiCredentials::password);
+    logBootPhase("Wi-Fi access point started");
+
+    raveLights.startWebServer();
+    logBootPhase("Web server started");
+
+    // Audio may be streamed over UDP, which needs the network stack
+    if (audioAnalyzer) {
+        Serial.println("Starting audio analysis...");
+        audioAnalyzer->start(0);
+    }
+
+    // Only test the LEDs when the rig is switched on, not when it recovers from a brownout mid-set
+    if (esp_reset_reason() == ESP_RST_POWERON) {
+        Serial.println("Testing LEDs...");
+        raveLights.requestSelfTest();
+    }
+
+    if (raveLights.getFirstFrameTimeUs() >= 0) {
+        Serial.printf("[%lld ms] First frame shown\n", raveLights.getFirstFrameTimeUs() / 1000);
+    }
+
+    while (true) {
+        raveLights.persistPatternConfig();
+        delay(CONFIG_PERSIST_INTERVAL_MS);
+    }
+}
+
 void setup() {
     Serial.begin(115200);
+#ifdef WAIT_FOR_SERIAL
     while (!Serial) {
         // Wait for serial port to be ready.
     }
+#endif
+    logBootPhase("Setup started");
     // Set thread config such that thread's stack suffices for RaveLights::show().
     // Use uxTaskGetStackHighWaterMark(NULL) inside thread to determine remaining stack space.
     auto thread_config = esp_pthread_get_default_config();
     thread_config.stack_size = 8192;
+    // Run the show loop on core 1, away from the Wi-Fi stack and web server on core 0.
+    thread_config.pin_to_core = 1;
     ESP_ERROR_CHECK(esp_pthread_set_cfg(&thread_config));
 
-    // Set network config
-    Network::initWifiAccessPoint(WifiCredentials::ssid, WifiCredentials::password);
-    // Network::connectToWifi(WifiCredentials::ssid, WifiCredentials::password);
-
-    // esp_random() produces true random number if wifi or bluetooth is running.
+    // Wi-Fi isn't running yet, so esp_random() is only pseudo random. This suffices for patterns.
     randomSeed(esp_random());
 
-    // Setup and start RaveLights
-    RaveLights<MAX_PIN_COUNT, PINS, RGB_ORDER> raveLights(lightsPerPin, PIXELS_PER_LIGHT);
+    // Setup and start RaveLights with the config that was active before the reset. Everything that isn't needed
+    // for the first frame comes up afterwards. Static, because it outlives this task.
+    static RaveLightsInstance raveLights(lightsPerPin, PIXELS_PER_LIGHT);
     for (auto &pattern : patterns) {
         raveLights.addPattern(pattern);
     }
+    raveLights.restorePatternConfig();
+    raveLights.setOutputGamma(OUTPUT_GAMMA);
 
-    Serial.println("Testing LEDs...");
-    raveLights.testLeds();
+    if (RENDER_WORKER_COUNT > 0) {
+        raveLights.enableParallelRendering(RENDER_WORKER_COUNT, 0);
+    }
 
-    Serial.println("Starting web server...");
-    raveLights.startWebServer();
+    if (USE_AUDIO_INPUT) {
+        auto audioSource =
+            std::make_shared<Audio::I2sAudioSource>(AUDIO_BIT_CLOCK_PIN, AUDIO_WORD_SELECT_PIN, AUDIO_DATA_PIN);
+        // auto audioSource = std::make_shared<Audio::UdpAudioSource>(5000);
+        audioAnalyzer = std::make_shared<Audio::AudioAnalyzer>(audioSource);
+        // Started once the network is up, patterns ignore the music until then
+        raveLights.setAudioAnalyzer(audioAnalyzer);
+    }
 
-    Serial.println("Starting show loop...");
     raveLights.startShowLoop();
+    logBootPhase("Show loop started");
 
-    while (true) {
-    }
+    xTaskCreatePinnedToCore(&runBackgroundSetup, "setup", 8192, &raveLights, 1, nullptr, 0);
+    // This task (loopTask) runs on core 1 with a lower priority than the show loop and has nothing left to do
+    vTaskDelete(nullptr);
 }
 
 void loop() {}
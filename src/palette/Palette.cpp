@@ -0,0 +1,63 @@
+#include "palette/Palette.hpp"
+
+#include <vector>
+
+namespace Palette {
+bool fillFromGradient(Lut &lut, const std::string &colorStops) {
+    std::vector<CRGB> stops;
+    size_t begin = 0;
+    while (begin <= colorStops.size()) {
+        size_t end = colorStops.find(',', begin);
+        if (end == std::string::npos) {
+            end = colorStops.size();
+        }
+        std::string stop = colorStops.substr(begin, end - begin);
+        char *parseEnd = nullptr;
+        unsigned long color = strtoul(stop.c_str(), &parseEnd, 16);
+        if (stop.empty() || *parseEnd != '\0' || color > 0xffffff) {
+            return false;
+        }
+        stops.push_back(CRGB(color));
+        begin = end + 1;
+    }
+    if (stops.size() < 2) {
+        return false;
+    }
+    // Position of each entry between the stops in 8.8 fixed point
+    const unsigned segmentCount = stops.size() - 1;
+    for (unsigned i = 0; i < lut.size(); i++) {
+        unsigned position = i * segmentCount * 256 / (lut.size() - 1);
+        unsigned segment = position >> 8;
+        if (segment == segmentCount) {
+            lut[i] = stops[segmentCount];
+        } else {
+            lut[i] = blend(stops[segment], stops[segment + 1], position & 0xff);
+        }
+    }
+    return true;
+}
+
+void fillFromHsvSweep(Lut &lut, uint8_t startHue, uint8_t hueRange, uint8_t saturation, uint8_t value) {
+    for (unsigned i = 0; i < lut.size(); i++) {
+        uint8_t hue = startHue + i * hueRange / lut.size();
+        hsv2rgb_rainbow(CHSV(hue, saturation, value), lut[i]);
+    }
+}
+
+void DoubleBufferedPalette::disable() {
+    std::lock_guard<std::mutex> lockGuard(backMutex_);
+    isBackEnabled_ = false;
+    isSwapPending_ = true;
+}
+
+void DoubleBufferedPalette::swapIfPending() {
+    // Don't block rendering while the back palette is being written, swap at the next frame boundary instead
+    std::unique_lock<std::mutex> lock(backMutex_, std::try_to_lock);
+    if (!lock.owns_lock() || !isSwapPending_) {
+        return;
+    }
+    frontIndex_ = 1 - frontIndex_;
+    isFrontEnabled_ = isBackEnabled_;
+    isSwapPending_ = false;
+}
+};  // namespace Palette
@@ -0,0 +1,50 @@
+#pragma once
+
+#define FASTLED_ESP32_I2S  // Alternative parallel output driver
+#include "FastLED.h"
+#include <array>
+#include <mutex>
+#include <string>
+
+namespace Palette {
+// Precomputed color lookup table which patterns index by position or time
+typedef std::array<CRGB, 256> Lut;
+
+// Evenly spaced color stops given as comma separated hex colors, e.g. "ff0000,0000ff".
+// Returns false and leaves lut untouched if colorStops can't be parsed.
+bool fillFromGradient(Lut &lut, const std::string &colorStops);
+// Sweeps hueRange / 256 of the color wheel beginning at startHue
+void fillFromHsvSweep(Lut &lut, uint8_t startHue, uint8_t hueRange, uint8_t saturation = 255, uint8_t value = 255);
+
+// Two palettes, of which the back one is written by the web server while the front one is used for rendering.
+// The render thread swaps them at frame boundaries, so that patterns never see a partially written palette.
+class DoubleBufferedPalette {
+   public:
+    DoubleBufferedPalette(){};
+
+    // Fills the back palette using fill(Lut &), which returns false if the palette is invalid.
+    template <typename Fill> bool update(Fill fill) {
+        std::lock_guard<std::mutex> lockGuard(backMutex_);
+        if (!fill(luts_[1 - frontIndex_])) {
+            return false;
+        }
+        isBackEnabled_ = true;
+        isSwapPending_ = true;
+        return true;
+    }
+    // Makes patterns use their plain color again at the next frame boundary
+    void disable();
+    // Must only be called by the render thread
+    void swapIfPending();
+    // Returns nullptr if no palette is enabled. Must only be called by the render thread.
+    const Lut *getActive() const { return isFrontEnabled_ ? &luts_[frontIndex_] : nullptr; }
+
+   private:
+    std::array<Lut, 2> luts_;
+    unsigned frontIndex_{0};
+    bool isFrontEnabled_{false};
+    bool isBackEnabled_{false};
+    bool isSwapPending_{false};
+    std::mutex backMutex_;
+};
+};  // namespace Palette
@@ -5,7 +5,7 @@ void AbstractPattern::init(unsigned rowCount, unsigned columnCount) {
     rowCount_ = rowCount;
     columnCount_ = columnCount;
     // esp_random() provides true random value if either WIFI or bluetooth is running
-    randomGenerator_.seed(esp_random());
+    randomGenerator_.seed(hasRandomSeed_ ? randomSeed_ : esp_random());
 }
 
 std::vector<unsigned> AbstractPattern::sampleColumns(unsigned amountOfRowsToSample) {
@@ -33,10 +33,37 @@ void AbstractPattern::lightUpColumn(std::vector<CRGB> &leds, unsigned columnInde
         leds[i] = color;
     }
     if (writeLeds) {
-        FastLED.show();
+        showImmediately();
     }
 }
 
+void AbstractPattern::lightUpColumnFromPalette(std::vector<CRGB> &leds, unsigned columnIndex,
+                                               uint8_t paletteStartIndex, bool writeLeds) {
+    // Walk through the whole palette once along the column, using 8.8 fixed point palette indices
+    const unsigned paletteStep = (256 << 8) / rowCount_;
+    unsigned paletteIndex = paletteStartIndex << 8;
+    const Palette::Lut &palette = *palette_;
+    for (unsigned i = getStartIndexOfColumn(columnIndex); i <= getEndIndexOfColumn(columnIndex); i++) {
+        leds[i] = palette[(paletteIndex >> 8) & 0xff];
+        paletteIndex += paletteStep;
+    }
+    if (writeLeds) {
+        showImmediately();
+    }
+}
+
+uint8_t AbstractPattern::getPaletteIndexForTime() {
+    // Cycle through the palette every ~4 seconds
+    return frameScheduler_->getClock().nowMs() / 16;
+}
+
+CRGB AbstractPattern::varyColor(CRGB color) {
+    if (palette_) {
+        return (*palette_)[random(256)];
+    }
+    return color ^ random(0xffffff + 1);
+}
+
 std::shared_ptr<std::discrete_distribution<>>
 AbstractPattern::createDiscreteProbabilityDistribution(std::vector<int> &distributionWeights) {
     // Weights which specify the likelihood for each amount of columns {0, ..., columnCount_}
@@ -73,20 +100,25 @@ unsigned AbstractPattern::flipPixelVertically(unsigned pixelIndex, int pixelColu
     }
     return getEndIndexOfColumn(pixelColumnIndex) - pixelIndex + getStartIndexOfColumn(pixelColumnIndex);
 }
-void AbstractPattern::showForEffectiveDuration(unsigned delayMs) { delay(showAndMeasureRemainingDuration(delayMs)); }
+// The frame is shown once the previous one has been on for its full duration and is kept for delayMs.
+// Returns without waiting, the next call or RaveLights waits for the frame to end.
+void AbstractPattern::showForEffectiveDuration(unsigned delayMs) { frameScheduler_->present(delayMs * 1000); }
+
+void AbstractPattern::showForEffectiveDurationUs(unsigned delayUs) { frameScheduler_->present(delayUs); }
+
+void AbstractPattern::showImmediately() { frameScheduler_->presentImmediately(); }
 
-unsigned AbstractPattern::showAndMeasureRemainingDuration(unsigned delayMs) {
-    unsigned long timeBeforeShow = millis();
-    FastLED.show();
-    unsigned passedTimeMs = millis() - timeBeforeShow;
-    if (delayMs > passedTimeMs) {
-        return delayMs - passedTimeMs;
+void AbstractPattern::parallelForColumns(const std::function<void(unsigned, unsigned)> &render) {
+    if (workerPool_) {
+        workerPool_->parallelForColumns(columnCount_, render);
+    } else {
+        render(0, columnCount_);
     }
-    return 0;
 }
+
 void AbstractPattern::indexToCoordinates(unsigned pixelIndex, unsigned &columnIndex, unsigned &rowIndex) {
-    columnIndex = pixelIndex / columnCount_;
-    rowIndex = pixelIndex % columnCount_;
+    columnIndex = pixelIndex / rowCount_;
+    rowIndex = pixelIndex % rowCount_;
 }
 unsigned AbstractPattern::coordinatesToIndex(unsigned columnIndex, unsigned rowIndex) {
     return columnIndex * rowCount_ + rowIndex;
@@ -97,6 +129,20 @@ bool AbstractPattern::sampleBernoulli(double probability) {
     return bernoulliDistr(randomGenerator_);
 }
 
+long AbstractPattern::random(long max) {
+    if (max <= 0) {
+        return 0;
+    }
+    return std::uniform_int_distribution<long>(0, max - 1)(randomGenerator_);
+}
+
+long AbstractPattern::random(long min, long max) {
+    if (min >= max) {
+        return min;
+    }
+    return min + random(max - min);
+}
+
 CRGB AbstractPattern::intensityToRgb(double intensity, CRGB color) {
     color.red = ((double)color.red) * intensity;
     color.green = ((double)color.green) * intensity;
@@ -2,8 +2,16 @@
 
 #define FASTLED_ESP32_I2S  // Alternative parallel output driver
 #include "FastLED.h"
+#include "audio/AudioAnalyzer.hpp"
+#include "palette/Palette.hpp"
+#include "render/ColumnWorkerPool.hpp"
+#include "render/HashRandom.hpp"
+#include "render/Rgb16.hpp"
+#include "timing/FrameScheduler.hpp"
+#include <functional>
 #include <memory>
 #include <random>
+#include <string>
 #include <vector>
 
 namespace Pattern {
@@ -12,30 +20,78 @@ class AbstractPattern {
     AbstractPattern(){};
     virtual void init(unsigned rowCount, unsigned columnCount);
     virtual unsigned perform(std::vector<CRGB> &leds, CRGB color) = 0;
+    // Palette to use during the next perform() or nullptr to use the plain color
+    void setPalette(const Palette::Lut *palette) { palette_ = palette; }
+    void setFrameScheduler(Timing::FrameScheduler *frameScheduler) { frameScheduler_ = frameScheduler; }
+    // Makes the pattern reproducible, e.g. for soak tests with a Timing::VirtualClock. Must be called before init(),
+    // which otherwise seeds from the hardware random number generator.
+    void setRandomSeed(uint32_t seed) {
+        randomSeed_ = seed;
+        hasRandomSeed_ = true;
+    }
+    // 16 bit per channel led buffer that is cleared before perform() if the pattern uses it
+    void setHighDepthBuffer(std::vector<Render::Rgb16> *highDepthLeds) { highDepthLeds_ = highDepthLeds; }
+    // Patterns that return true draw into highDepthLeds_ instead of leds, for smooth fades at low brightness.
+    // RaveLights quantizes it to leds right before each frame is shown.
+    virtual bool usesHighDepthBuffer() const { return false; }
+    // Worker pool used by parallelForColumns() or nullptr to render on the calling thread only
+    void setWorkerPool(Render::ColumnWorkerPool *workerPool) { workerPool_ = workerPool; }
+    // Audio features at the start of the next perform()
+    void setAudioFeatures(const Audio::AudioFeatures &audioFeatures) { audioFeatures_ = audioFeatures; }
+    // Whether RaveLights should end the off duration early when an onset (kick) is detected
+    virtual bool isTriggeredByOnsets() const { return false; }
+    // Replaces the program of patterns that are written in the pattern language
+    virtual bool loadProgram(const std::string &source, std::string &error) {
+        error = "Pattern is not programmable";
+        return false;
+    }
+    // Sets a named parameter, e.g. from a cue list. Called between two performs, returns false for unknown names.
+    virtual bool setParameter(const std::string &name, float value) { return false; }
+    // Whether the pattern switches all lights off, used for blackout cues
+    virtual bool isBlackout() const { return false; }
 
    protected:
     unsigned rowCount_{0};
     unsigned columnCount_{0};
     std::default_random_engine randomGenerator_;
+    const Palette::Lut *palette_{nullptr};
+    Timing::FrameScheduler *frameScheduler_{nullptr};
+    Audio::AudioFeatures audioFeatures_;
+    Render::ColumnWorkerPool *workerPool_{nullptr};
+    std::vector<Render::Rgb16> *highDepthLeds_{nullptr};
 
     // Utility functions used across patterns
     std::vector<unsigned> sampleColumns(unsigned columnCount);
     unsigned getStartIndexOfColumn(unsigned column);
     unsigned getEndIndexOfColumn(unsigned column);
     void lightUpColumn(std::vector<CRGB> &leds, unsigned columnIndex, CRGB color, bool writeLeds = true);
+    void lightUpColumnFromPalette(std::vector<CRGB> &leds, unsigned columnIndex, uint8_t paletteStartIndex,
+                                  bool writeLeds = true);
+    uint8_t getPaletteIndexForTime();
+    CRGB varyColor(CRGB color);
     std::shared_ptr<std::discrete_distribution<>>
     createDiscreteProbabilityDistribution(std::vector<int> &distributionWeights);
     unsigned invertColor(unsigned color);
     bool isColumnCompletelyDark(std::vector<CRGB> &leds, unsigned columnIndex);
     unsigned flipPixelVertically(unsigned pixelIndex, int pixelColumnIndex, bool flipPixel = true);
-    unsigned showAndMeasureRemainingDuration(unsigned delayMs);
     void showForEffectiveDuration(unsigned delayMs);
+    void showForEffectiveDurationUs(unsigned delayUs);
+    void showImmediately();
+    // Calls render(firstColumn, endColumn) for ranges covering all columns, possibly on several threads at once.
+    // render must only touch pixels and state of its own columns and only call thread safe functions. Draw random
+    // numbers with Render::hashRandom() from a seed taken from randomGenerator_ before, not with random().
+    void parallelForColumns(const std::function<void(unsigned, unsigned)> &render);
     void indexToCoordinates(unsigned pixelIndex, unsigned &columnIndex, unsigned &rowIndex);
     unsigned coordinatesToIndex(unsigned columnIndex, unsigned rowIndex);
     bool sampleBernoulli(double chance);
+    // Replace Arduino's random() within patterns, so that all their random numbers come from randomGenerator_
+    long random(long max);
+    long random(long min, long max);
     CRGB intensityToRgb(double intensity, CRGB color);
 
    private:
+    uint32_t randomSeed_{0};
+    bool hasRandomSeed_{false};
 };
 
 // template <typename T> int sgn(T val);
@@ -3,7 +3,8 @@
 namespace Pattern {
 
 unsigned Blackout::perform(std::vector<CRGB> &leds, CRGB color) {
-    FastLED.clear(true);
+    FastLED.clear(false);
+    showImmediately();
     return 0;
 }
 };  // namespace Pattern
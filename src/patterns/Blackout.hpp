@@ -7,6 +7,7 @@ class Blackout : public AbstractPattern {
    public:
     Blackout() : AbstractPattern(){};
     unsigned perform(std::vector<CRGB> &leds, CRGB color) override;
+    bool isBlackout() const override { return true; }
 
    private:
 };
@@ -0,0 +1,248 @@
+#include "patterns/BytecodePattern.hpp"
+
+#include "bytecode/Assembler.hpp"
+#include <cmath>
+
+namespace Pattern {
+using namespace Bytecode;
+
+BytecodePattern::BytecodePattern(const std::string &source) : AbstractPattern() {
+    std::string error;
+    if (!loadProgram(source, error)) {
+        Serial.println(("Error. Invalid built-in program, " + error).c_str());
+    }
+}
+
+bool BytecodePattern::loadProgram(const std::string &source, std::string &error) {
+    std::vector<uint8_t> code;
+    if (!assemble(source, code, error)) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lockGuard(pendingCodeMutex_);
+    pendingCode_.swap(code);
+    isCodePending_ = true;
+    return true;
+}
+
+bool BytecodePattern::setParameter(const std::string &name, float value) {
+    char *end = nullptr;
+    if (name.size() < 2 || name[0] != 'r') {
+        return false;
+    }
+    unsigned long index = strtoul(name.c_str() + 1, &end, 10);
+    if (*end != '\0' || index >= registers_.size()) {
+        return false;
+    }
+    registers_[index] = std::lround(value);
+    return true;
+}
+
+unsigned BytecodePattern::perform(std::vector<CRGB> &leds, CRGB color) {
+    {
+        std::unique_lock<std::mutex> lock(pendingCodeMutex_, std::try_to_lock);
+        if (lock.owns_lock() && isCodePending_) {
+            code_.swap(pendingCode_);
+            registers_.fill(0);
+            isCodePending_ = false;
+        }
+    }
+    if (code_.empty()) {
+        showForEffectiveDuration(0);
+        return 100;
+    }
+    return execute(leds, color);
+}
+
+// Threaded interpreter: every instruction handler jumps directly to the handler of the next instruction through a
+// table of label addresses (GCC's computed goto), instead of returning to a central switch statement.
+unsigned BytecodePattern::execute(std::vector<CRGB> &leds, CRGB color) {
+    static const void *const DISPATCH_TABLE[OPCODE_COUNT] = {
+        &&END_,   &&STOP_,  &&SET_,      &&MOV_,     &&ADD_,     &&SUB_,   &&MUL_,     &&DIV_,
+        &&MOD_,   &&MIN_,   &&MAX_,      &&ADDI_,    &&RAND_,    &&JMP_,   &&JZ_,      &&JNZ_,
+        &&JLT_,   &&ROWS_,  &&COLS_,     &&TIME_,    &&COLOR_,   &&BASECOLOR_, &&PALETTE_, &&SCALE_,
+        &&PIXEL_, &&SPAN_,  &&FILLCOL_,  &&FADE_,    &&FADECOL_, &&LIT_,   &&CLEAR_,   &&SHOW_,
+    };
+    const uint8_t *const code = code_.data();
+    const uint8_t *pc = code;
+    int32_t *const r = registers_.data();
+    unsigned remainingInstructions = MAX_INSTRUCTIONS_PER_FRAME_;
+    unsigned remainingFrames = MAX_FRAMES_PER_PERFORM_;
+    uint32_t remainingShowTimeMs = MAX_SHOW_TIME_PER_PERFORM_MS_;
+    uint32_t frameDurationMs = 0;
+    CRGB drawColor = color;
+    const unsigned columnCount = columnCount_;
+    const unsigned rowCount = rowCount_;
+
+#define DISPATCH()                              \
+    do {                                        \
+        if (--remainingInstructions == 0) {     \
+            goto INSTRUCTION_BUDGET_EXCEEDED_;  \
+        }                                       \
+        goto *DISPATCH_TABLE[*pc++];            \
+    } while (0)
+
+    DISPATCH();
+
+END_:
+    return constrain(r[pc[0]], 0, (int32_t)MAX_DURATION_MS_);
+STOP_:
+    return 0;
+SET_:
+    r[pc[0]] = readImmediate(pc + 1);
+    pc += 5;
+    DISPATCH();
+MOV_:
+    r[pc[0]] = r[pc[1]];
+    pc += 2;
+    DISPATCH();
+ADD_:
+    r[pc[0]] = wrappingAdd(r[pc[1]], r[pc[2]]);
+    pc += 3;
+    DISPATCH();
+SUB_:
+    r[pc[0]] = wrappingSub(r[pc[1]], r[pc[2]]);
+    pc += 3;
+    DISPATCH();
+MUL_:
+    r[pc[0]] = wrappingMul(r[pc[1]], r[pc[2]]);
+    pc += 3;
+    DISPATCH();
+DIV_:
+    // INT32_MIN / -1 overflows, so dividing by -1 is negation
+    if (r[pc[2]] == 0) {
+        r[pc[0]] = 0;
+    } else if (r[pc[2]] == -1) {
+        r[pc[0]] = wrappingSub(0, r[pc[1]]);
+    } else {
+        r[pc[0]] = r[pc[1]] / r[pc[2]];
+    }
+    pc += 3;
+    DISPATCH();
+MOD_:
+    r[pc[0]] = r[pc[2]] == 0 || r[pc[2]] == -1 ? 0 : r[pc[1]] % r[pc[2]];
+    pc += 3;
+    DISPATCH();
+MIN_:
+    r[pc[0]] = min(r[pc[1]], r[pc[2]]);
+    pc += 3;
+    DISPATCH();
+MAX_:
+    r[pc[0]] = max(r[pc[1]], r[pc[2]]);
+    pc += 3;
+    DISPATCH();
+ADDI_:
+    r[pc[0]] = wrappingAdd(r[pc[1]], readImmediate(pc + 2));
+    pc += 6;
+    DISPATCH();
+RAND_:
+    r[pc[0]] = r[pc[1]] > 0 ? random(r[pc[1]]) : 0;
+    pc += 2;
+    DISPATCH();
+JMP_:
+    pc = code + readJumpTarget(pc);
+    DISPATCH();
+JZ_:
+    pc = r[pc[0]] == 0 ? code + readJumpTarget(pc + 1) : pc + 3;
+    DISPATCH();
+JNZ_:
+    pc = r[pc[0]] != 0 ? code + readJumpTarget(pc + 1) : pc + 3;
+    DISPATCH();
+JLT_:
+    pc = r[pc[0]] < r[pc[1]] ? code + readJumpTarget(pc + 2) : pc + 4;
+    DISPATCH();
+ROWS_:
+    r[pc[0]] = rowCount;
+    pc += 1;
+    DISPATCH();
+COLS_:
+    r[pc[0]] = columnCount;
+    pc += 1;
+    DISPATCH();
+TIME_:
+    r[pc[0]] = frameScheduler_->getClock().nowMs();
+    pc += 1;
+    DISPATCH();
+COLOR_:
+    drawColor = CRGB((uint32_t)r[pc[0]]);
+    pc += 1;
+    DISPATCH();
+BASECOLOR_:
+    r[pc[0]] = (color.r << 16) | (color.g << 8) | color.b;
+    pc += 1;
+    DISPATCH();
+PALETTE_:
+    drawColor = palette_ ? (*palette_)[r[pc[0]] & 0xff] : color;
+    pc += 1;
+    DISPATCH();
+SCALE_:
+    drawColor.nscale8_video(constrain(r[pc[0]], 0, 255));
+    pc += 1;
+    DISPATCH();
+PIXEL_:
+    if ((unsigned)r[pc[0]] < columnCount && (unsigned)r[pc[1]] < rowCount) {
+        leds[coordinatesToIndex(r[pc[0]], r[pc[1]])] = drawColor;
+    }
+    pc += 2;
+    DISPATCH();
+SPAN_:
+    if ((unsigned)r[pc[0]] < columnCount) {
+        const int startRow = constrain(r[pc[1]], 0, (int)rowCount);
+        const int endRow = constrain((int64_t)r[pc[1]] + r[pc[2]], (int64_t)startRow, (int64_t)rowCount);
+        const unsigned columnStart = getStartIndexOfColumn(r[pc[0]]);
+        for (unsigned i = columnStart + startRow; i < columnStart + endRow; i++) {
+            leds[i] = drawColor;
+        }
+    }
+    pc += 3;
+    DISPATCH();
+FILLCOL_:
+    if ((unsigned)r[pc[0]] < columnCount) {
+        lightUpColumn(leds, r[pc[0]], drawColor, false);
+    }
+    pc += 1;
+    DISPATCH();
+FADE_:
+    fadeToBlackBy(leds.data(), leds.size(), constrain(r[pc[0]], 0, 255));
+    pc += 1;
+    DISPATCH();
+FADECOL_:
+    if ((unsigned)r[pc[0]] < columnCount) {
+        fadeToBlackBy(&leds[getStartIndexOfColumn(r[pc[0]])], rowCount, constrain(r[pc[1]], 0, 255));
+    }
+    pc += 2;
+    DISPATCH();
+LIT_:
+    if ((unsigned)r[pc[1]] < columnCount) {
+        const unsigned columnStart = getStartIndexOfColumn(r[pc[1]]);
+        int32_t litCount = 0;
+        for (unsigned i = columnStart; i < columnStart + rowCount; i++) {
+            litCount += leds[i] ? 1 : 0;
+        }
+        r[pc[0]] = litCount;
+    } else {
+        r[pc[0]] = 0;
+    }
+    pc += 2;
+    DISPATCH();
+CLEAR_:
+    FastLED.clearData();
+    DISPATCH();
+SHOW_:
+    frameDurationMs = constrain(r[pc[0]], 0, (int32_t)MAX_DURATION_MS_);
+    showForEffectiveDuration(frameDurationMs);
+    pc += 1;
+    remainingShowTimeMs -= min(remainingShowTimeMs, frameDurationMs);
+    if (--remainingFrames == 0 || remainingShowTimeMs == 0 || frameScheduler_->isInterruptRequested()) {
+        return 0;
+    }
+    remainingInstructions = MAX_INSTRUCTIONS_PER_FRAME_;
+    DISPATCH();
+
+INSTRUCTION_BUDGET_EXCEEDED_:
+    Serial.println("Error. Program exceeded its instruction budget.");
+    FastLED.clearData();
+    showForEffectiveDuration(0);
+    return 1000;
+#undef DISPATCH
+}
+};  // namespace Pattern
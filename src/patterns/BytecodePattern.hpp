@@ -0,0 +1,41 @@
+#pragma once
+
+#include "bytecode/Opcodes.hpp"
+#include "patterns/AbstractPattern.hpp"
+#include <array>
+#include <mutex>
+#include <string>
+
+namespace Pattern {
+// Runs a program written in the pattern language (see bytecode/Assembler.hpp), which can be replaced at runtime.
+// Registers keep their values across performs, each perform() runs the program from the start.
+class BytecodePattern : public AbstractPattern {
+   public:
+    BytecodePattern() : AbstractPattern(){};
+    // Optionally starts with the given program
+    BytecodePattern(const std::string &source);
+    unsigned perform(std::vector<CRGB> &leds, CRGB color) override;
+    // May be called from any thread. The program takes effect at the start of the next perform().
+    bool loadProgram(const std::string &source, std::string &error) override;
+    // Parameters are the registers "r0" to "r15", the value is rounded to an integer
+    bool setParameter(const std::string &name, float value) override;
+
+   private:
+    // A runaway program is stopped after executing this many instructions without showing a frame
+    static const unsigned MAX_INSTRUCTIONS_PER_FRAME_ = 20000;
+    // perform() returns after this many frames or once its frames add up to this duration, so that pattern changes
+    // aren't blocked by endless loops. It also returns after the current frame if the frame scheduler is interrupted.
+    static const unsigned MAX_FRAMES_PER_PERFORM_ = 1000;
+    static const uint32_t MAX_SHOW_TIME_PER_PERFORM_MS_ = 5000;
+    // Longest frame and off duration, so that durations in microseconds fit into 32 bits
+    static const uint32_t MAX_DURATION_MS_ = 60000;
+
+    std::vector<uint8_t> code_;
+    std::array<int32_t, Bytecode::REGISTER_COUNT> registers_{};
+    std::vector<uint8_t> pendingCode_;
+    bool isCodePending_{false};
+    std::mutex pendingCodeMutex_;
+
+    unsigned execute(std::vector<CRGB> &leds, CRGB color);
+};
+};  // namespace Pattern
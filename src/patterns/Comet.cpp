@@ -1,19 +1,17 @@
 #include "patterns/Comet.hpp"
 
 namespace Pattern {
-void Comet::fadeRandomPixelsToBlackBy(std::vector<CRGB> &leds, unsigned startIndex, unsigned endIndex,
-                                      uint8_t fadeAmount) {
-    for (unsigned i = startIndex; i <= endIndex; i++) {
-        if (random(0, 2) == 1) {
-            leds[i].fadeToBlackBy(fadeAmount);
-        }
-    }
+void Comet::init(unsigned rowCount, unsigned columnCount) {
+    AbstractPattern::init(rowCount, columnCount);
+    comets_.init(rowCount, columnCount);
+    trails_.init(rowCount, columnCount);
 }
 
-unsigned Comet::perform(std::vector<CRGB> &leds, CRGB color) {
+unsigned Comet::perform(std::vector<CRGB> &, CRGB color) {
+    std::vector<Render::Rgb16> &leds = *highDepthLeds_;
     const unsigned cometSize = rowCount_ / 8;
+    const float cometSpeed = 1 + columnCount_;
     uint8_t fadeAmount = 100;  // Decrease brightness by (fadeAmount/ 256) * brightness
-    unsigned cometStartIndex = 0;
     unsigned onDuration = 30;
     bool flipPattern = sampleBernoulli(0.5);
     unsigned numOfColumnsToLightup = 0;
@@ -23,30 +21,33 @@ unsigned Comet::perform(std::vector<CRGB> &leds, CRGB color) {
         numOfColumnsToLightup = random(1, columnCount_ + 1);
     }
     auto columnsToLightUp = sampleColumns(numOfColumnsToLightup);
-    // Draw comet and its trail until the end of the column is reached
-    while (cometStartIndex + cometSize < rowCount_) {
-        // Draw comet
-        for (unsigned i = 0; i < cometSize; i++) {
-            for (auto columnIndex : columnsToLightUp) {
-                leds[flipPixelVertically(getStartIndexOfColumn(columnIndex) + cometStartIndex + i, columnIndex,
-                                         flipPattern)] = color;
-            }
-        }
-        for (auto columnIndex : columnsToLightUp) {
-            // Fade half of the LEDs one step
-            fadeRandomPixelsToBlackBy(leds, getStartIndexOfColumn(columnIndex), getEndIndexOfColumn(columnIndex),
-                                      fadeAmount);
+    // Fades half of the LEDs one step. Columns without a comet are dark and cost nothing.
+    uint32_t fadeSeed = 0;
+    auto fadeTrails = [&](unsigned firstColumn, unsigned endColumn) {
+        for (unsigned columnIndex = firstColumn; columnIndex < endColumn; columnIndex++) {
+            trails_.fadeRandomPixelsToBlackBy(leds, columnIndex, fadeAmount, fadeSeed);
         }
+    };
+    for (auto columnIndex : columnsToLightUp) {
+        comets_.spawn(columnIndex, 0, cometSpeed, cometSize);
+    }
+    // The led buffer has been cleared before perform() is called
+    trails_.clear();
+    // Draw comets and their trails until they have left the columns
+    while (comets_.size() > 0) {
+        comets_.render(color, flipPattern, [&](unsigned pixelIndex, CRGB cometColor) {
+            trails_.setPixel(leds, pixelIndex, Render::Rgb16(cometColor));
+        });
+        fadeSeed = randomGenerator_();
+        parallelForColumns(fadeTrails);
         showForEffectiveDuration(onDuration);
-        cometStartIndex += 1 + columnCount_;
+        comets_.update();
     }
 
-    // Fade remaining pixels to complete darkness
-    while (!isColumnCompletelyDark(leds, columnsToLightUp[random(0, columnsToLightUp.size())])) {
-        for (auto columnIndex : columnsToLightUp) {
-            fadeRandomPixelsToBlackBy(leds, getStartIndexOfColumn(columnIndex), getEndIndexOfColumn(columnIndex),
-                                      fadeAmount);
-        }
+    // Fade remaining pixels of all columns to complete darkness
+    while (!trails_.isDark()) {
+        fadeSeed = randomGenerator_();
+        parallelForColumns(fadeTrails);
         showForEffectiveDuration(onDuration);
     }
 
@@ -1,14 +1,22 @@
 #pragma once
 
 #include "patterns/AbstractPattern.hpp"
+#include "patterns/DecayBuffer.hpp"
+#include "patterns/ParticleSystem.hpp"
 
 namespace Pattern {
 class Comet : public AbstractPattern {
    public:
-    Comet() : AbstractPattern(){};
+    Comet() : AbstractPattern(), comets_(MAX_COMET_COUNT_){};
     unsigned perform(std::vector<CRGB> &leds, CRGB color) override;
+    void init(unsigned rowCount, unsigned columnCount) override;
+    // The trails fade out smoothly instead of in visible steps
+    bool usesHighDepthBuffer() const override { return true; }
 
    private:
-    void fadeRandomPixelsToBlackBy(std::vector<CRGB> &leds, unsigned startIndex, unsigned endIndex, uint8_t fadeAmount);
+    // perform() lights up 2 or 3 columns at the same time, and up to all columns of rigs with fewer than 5
+    static const unsigned MAX_COMET_COUNT_ = 4;
+    ParticleSystem comets_;
+    DecayBuffer trails_;
 };
 };  // namespace Pattern
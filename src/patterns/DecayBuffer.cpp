@@ -0,0 +1,105 @@
+#include "patterns/DecayBuffer.hpp"
+
+namespace Pattern {
+// Slot of pixels that are dark
+const uint16_t NOT_LIT = 0xffff;
+
+void DecayBuffer::init(unsigned rowCount, unsigned columnCount) {
+    rowCount_ = rowCount;
+    columnCount_ = columnCount;
+    litCount_ = 0;
+    litCountPerColumn_.assign(columnCount, 0);
+    litRows_.assign(rowCount * columnCount, 0);
+    slotOfPixel_.assign(rowCount * columnCount, NOT_LIT);
+}
+
+template <typename Pixel> void DecayBuffer::setPixel(std::vector<Pixel> &leds, unsigned pixelIndex, Pixel color) {
+    leds[pixelIndex] = color;
+    const unsigned columnIndex = pixelIndex / rowCount_;
+    const bool isLit = slotOfPixel_[pixelIndex] != NOT_LIT;
+    if (color && !isLit) {
+        markLit(columnIndex, pixelIndex - columnIndex * rowCount_);
+    } else if (!color && isLit) {
+        markDark(columnIndex, slotOfPixel_[pixelIndex]);
+    }
+}
+
+template <typename Pixel>
+void DecayBuffer::fadeRandomPixelsToBlackBy(std::vector<Pixel> &leds, unsigned columnIndex, uint8_t fadeAmount,
+                                            uint32_t seed) {
+    const unsigned columnOffset = columnIndex * rowCount_;
+    unsigned randomCounter = columnOffset;
+    uint32_t randomBits = 0;
+    unsigned remainingRandomBits = 0;
+    // Iterate backwards, so that markDark() only moves slots that have already been visited
+    for (unsigned slot = litCountPerColumn_[columnIndex]; slot-- > 0;) {
+        // Draw 32 coin flips at once instead of one random number per pixel
+        if (remainingRandomBits == 0) {
+            randomBits = Render::hashRandom(seed, randomCounter++);
+            remainingRandomBits = 32;
+        }
+        bool doFade = randomBits & 1;
+        randomBits >>= 1;
+        remainingRandomBits--;
+        if (!doFade) {
+            continue;
+        }
+        Pixel &pixel = leds[columnOffset + litRows_[columnOffset + slot]];
+        pixel.fadeToBlackBy(fadeAmount);
+        if (!pixel) {
+            markDark(columnIndex, slot);
+        }
+    }
+}
+
+template <typename Pixel>
+void DecayBuffer::fadeToBlackBy(std::vector<Pixel> &leds, unsigned columnIndex, uint8_t fadeAmount) {
+    const unsigned columnOffset = columnIndex * rowCount_;
+    for (unsigned slot = litCountPerColumn_[columnIndex]; slot-- > 0;) {
+        Pixel &pixel = leds[columnOffset + litRows_[columnOffset + slot]];
+        pixel.fadeToBlackBy(fadeAmount);
+        if (!pixel) {
+            markDark(columnIndex, slot);
+        }
+    }
+}
+
+void DecayBuffer::clear() {
+    for (unsigned columnIndex = 0; columnIndex < columnCount_; columnIndex++) {
+        const unsigned columnOffset = columnIndex * rowCount_;
+        for (unsigned slot = 0; slot < litCountPerColumn_[columnIndex]; slot++) {
+            slotOfPixel_[columnOffset + litRows_[columnOffset + slot]] = NOT_LIT;
+        }
+        litCountPerColumn_[columnIndex] = 0;
+    }
+    litCount_ = 0;
+}
+
+void DecayBuffer::markLit(unsigned columnIndex, unsigned rowIndex) {
+    const unsigned columnOffset = columnIndex * rowCount_;
+    const unsigned slot = litCountPerColumn_[columnIndex]++;
+    litRows_[columnOffset + slot] = rowIndex;
+    slotOfPixel_[columnOffset + rowIndex] = slot;
+    litCount_++;
+}
+
+void DecayBuffer::markDark(unsigned columnIndex, unsigned slot) {
+    const unsigned columnOffset = columnIndex * rowCount_;
+    const unsigned lastSlot = --litCountPerColumn_[columnIndex];
+    slotOfPixel_[columnOffset + litRows_[columnOffset + slot]] = NOT_LIT;
+    // Fill the gap with the last lit pixel of the column
+    if (slot != lastSlot) {
+        const uint16_t movedRow = litRows_[columnOffset + lastSlot];
+        litRows_[columnOffset + slot] = movedRow;
+        slotOfPixel_[columnOffset + movedRow] = slot;
+    }
+    litCount_--;
+}
+
+template void DecayBuffer::setPixel(std::vector<CRGB> &, unsigned, CRGB);
+template void DecayBuffer::setPixel(std::vector<Render::Rgb16> &, unsigned, Render::Rgb16);
+template void DecayBuffer::fadeRandomPixelsToBlackBy(std::vector<CRGB> &, unsigned, uint8_t, uint32_t);
+template void DecayBuffer::fadeRandomPixelsToBlackBy(std::vector<Render::Rgb16> &, unsigned, uint8_t, uint32_t);
+template void DecayBuffer::fadeToBlackBy(std::vector<CRGB> &, unsigned, uint8_t);
+template void DecayBuffer::fadeToBlackBy(std::vector<Render::Rgb16> &, unsigned, uint8_t);
+};  // namespace Pattern
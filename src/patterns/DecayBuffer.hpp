@@ -0,0 +1,47 @@
+#pragma once
+
+#define FASTLED_ESP32_I2S  // Alternative parallel output driver
+#include "FastLED.h"
+#include "render/HashRandom.hpp"
+#include "render/Rgb16.hpp"
+#include <atomic>
+#include <vector>
+
+namespace Pattern {
+// Keeps track of which pixels of the led buffer are lit, per column, for effects that leave fading trails.
+// Pixels must be written through setPixel() so that "is dark" queries are O(1) and fading only visits lit pixels.
+// Call clear() whenever the led buffer has been cleared elsewhere, e.g. at the start of perform().
+// Different columns may be modified concurrently (see AbstractPattern::parallelForColumns()).
+// Works with 8 bit (CRGB) as well as 16 bit (Render::Rgb16) led buffers.
+class DecayBuffer {
+   public:
+    DecayBuffer(){};
+    void init(unsigned rowCount, unsigned columnCount);
+
+    template <typename Pixel> void setPixel(std::vector<Pixel> &leds, unsigned pixelIndex, Pixel color);
+    // Fades each lit pixel of the column by fadeAmount / 256 with 50% probability. The coin flips are derived from
+    // seed (see Render::hashRandom()), pass a new one for every frame.
+    template <typename Pixel>
+    void fadeRandomPixelsToBlackBy(std::vector<Pixel> &leds, unsigned columnIndex, uint8_t fadeAmount, uint32_t seed);
+    template <typename Pixel> void fadeToBlackBy(std::vector<Pixel> &leds, unsigned columnIndex, uint8_t fadeAmount);
+    void clear();
+
+    unsigned getLitPixelCount(unsigned columnIndex) const { return litCountPerColumn_[columnIndex]; }
+    bool isColumnDark(unsigned columnIndex) const { return litCountPerColumn_[columnIndex] == 0; }
+    bool isDark() const { return litCount_ == 0; }
+
+   private:
+    unsigned rowCount_{0};
+    unsigned columnCount_{0};
+    std::atomic<unsigned> litCount_{0};
+    std::vector<unsigned> litCountPerColumn_;
+    // For each column, the first litCountPerColumn_[column] entries of its rowCount_ sized section hold the rows
+    // of the lit pixels in arbitrary order.
+    std::vector<uint16_t> litRows_;
+    // Position of each pixel's row within its column's section of litRows_, or NOT_LIT
+    std::vector<uint16_t> slotOfPixel_;
+
+    void markLit(unsigned columnIndex, unsigned rowIndex);
+    void markDark(unsigned columnIndex, unsigned slot);
+};
+};  // namespace Pattern
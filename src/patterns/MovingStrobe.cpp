@@ -1,25 +1,25 @@
 #include "MovingStrobe.hpp"
 
-#include <set>
+#include <algorithm>
 
 namespace Pattern {
-template <typename T> int sgn(T val) { return (T(0) < val) - (val < T(0)); }
-
 MovingStrobe::MovingStrobe(double p_bigstrobe, double p_pause, double p_thin)
-    : AbstractPattern(), bigStrobeProb_(p_bigstrobe), pauseProb_(p_pause), thinningProb_(p_thin) {
-    reset();
-}
+    : AbstractPattern(), bigStrobeProb_(p_bigstrobe), pauseProb_(p_pause), thinningProb_(p_thin) {}
 
 void MovingStrobe::reset() {
     distortionProb_ = uniformDist_005_02_(randomGenerator_);
-    light = random(lightCount_);
     frame = 0;
-    pos = max(std::lround(abs(normalDist_0_1_(randomGenerator_) * pixelCount_)), (long)0);
-    error = 0;
-    speed = random(1, 5 + 1);
-    length = random(5, 30 + 1);
     maxFrameCount_ = random(5, 25 + 1);
-    errorSpeed_ = max(normalDist_2_05_(randomGenerator_), (double)1);
+
+    // apply direction
+    float speed = random(1, 5 + 1);
+    if (doRandomDirection_ && sampleBernoulli(0.5)) {
+        speed = -speed;
+    }
+    float position = abs(normalDist_0_1_(randomGenerator_)) * pixelsPerLight_;
+    float length = random(5, 30 + 1);
+    strobe_.clear();
+    strobe_.spawn(random(lightCount_), position, speed, length);
 
     // special mode : bigstrobe
     doBigStrobe_ = false;
@@ -40,65 +40,52 @@ void MovingStrobe::reset() {
     }
 }
 
-unsigned MovingStrobe::perform(std::vector<CRGB> &leds, CRGB color) {
-    FastLED.clearData();
+unsigned MovingStrobe::perform(std::vector<CRGB> &, CRGB color) {
+    // Cleared by RaveLights before every perform()
+    std::vector<Render::Rgb16> &leds = *highDepthLeds_;
     frame++;
-    // see if animation is finished
-    if (frame > maxFrameCount_) {
+    // see if animation is finished or the strobe has left its light
+    if (frame > maxFrameCount_ || strobe_.size() == 0) {
         reset();
     }
     if (doPause_) {
-        return showAndMeasureRemainingDuration(1000 / 30);
-    }
-    // apply direction
-    // !possibly broken
-    int direction = 1;
-    if (doRandomDirection_ && !sampleBernoulli(0.5)) {
-        direction = -1;
+        showForEffectiveDurationUs(FRAME_DURATION_US_);
+        return 0;
     }
     // get intensity
     double intens = min((double)1, abs(std::sin(frame * sinFactor_)) + 0.1);
-    // update position
-    pos = direction * std::lround(pos + error);
-    pos += speed;
-    error = -sgn(error) * (abs(error) + errorSpeed_);
-    const unsigned offset = light * pixelsPerLight_;
-    int a = max(0, pos) + offset;
-    int b = min(pixelsPerLight_, pos + length) + offset;
-    b = max(b, 1);
-    if (a >= b) {
-        a = b - 1;
-    }
-    // bigstrobe
+    const Render::Rgb16 strobeColor = Render::Rgb16(color).nscale16(intens * UINT16_MAX);
+    unsigned a, b;
     if (doBigStrobe_) {
         int border1 = random(0, pixelCount_);
         int border2 = random(0, pixelCount_);
         a = min(border1, border2);
         b = max(border1, border2);
+    } else {
+        strobe_.getPixelRange(0, a, b);
+        strobe_.update();
     }
+    std::fill(leds.begin() + a, leds.begin() + b, strobeColor);
     // thinning and global distortion
-    // Setup discrete probability distribution
-    std::vector<int> weights(thinningAmount_, 1);
-    std::discrete_distribution<int> discreteDist{weights.begin(), weights.end()};
-    for (int i = a; i < b; i++) {
-        if (doThinning_) {
-            // pick thinning-1 numbers in {0,...,thinning-1}
-            std::set<int> choices{};
-            for (int j = 0; j < thinningAmount_; j++) {
-                choices.insert(discreteDist(randomGenerator_));
-            }
-
-            if (choices.find(i % thinningAmount_) != choices.end()) {
-                continue;
+    // A pixel is thinned out if its index modulo thinningAmount_ is hit by any of thinningAmount_ uniform draws
+    // from {0, ..., thinningAmount_ - 1}. This happens independently for each pixel with the probability below.
+    const double thinnedOutProb = 1 - std::pow(1 - 1.0 / thinningAmount_, thinningAmount_);
+    // Pixels are thinned out in parallel, so random numbers are derived from a seed with Render::hashRandom()
+    const uint32_t seed = randomGenerator_();
+    const uint32_t thinnedOutThreshold = doThinning_ ? thinnedOutProb * UINT32_MAX : 0;
+    const uint32_t distortionThreshold = distortionProb_ * UINT32_MAX;
+    parallelForColumns([&](unsigned firstColumn, unsigned endColumn) {
+        const unsigned first = max(a, getStartIndexOfColumn(firstColumn));
+        const unsigned end = min(b, getStartIndexOfColumn(endColumn));
+        for (unsigned i = first; i < end; i++) {
+            if (Render::hashRandom(seed, 2 * i) < thinnedOutThreshold ||
+                Render::hashRandom(seed, 2 * i + 1) < distortionThreshold) {
+                leds[i] = Render::Rgb16();
             }
         }
-        if (sampleBernoulli(distortionProb_)) {
-            leds[i] = intensityToRgb(0, color);
-        } else {
-            leds[i] = intensityToRgb(intens, color);
-        }
-    }
-    return showAndMeasureRemainingDuration(1000 / 30);
+    });
+    showForEffectiveDurationUs(FRAME_DURATION_US_);
+    return 0;
 }
 
 void MovingStrobe::init(unsigned rowCount, unsigned columnCount) {
@@ -106,6 +93,7 @@ void MovingStrobe::init(unsigned rowCount, unsigned columnCount) {
     lightCount_ = columnCount_;
     pixelsPerLight_ = rowCount_;
     pixelCount_ = columnCount_ * rowCount_;
+    strobe_.init(rowCount, columnCount);
     reset();
 }
 };  // namespace Pattern
@@ -8,28 +8,31 @@ void MultipleStrobeFlashes::init(unsigned rowCount, unsigned columnCount) {
 }
 
 unsigned MultipleStrobeFlashes::perform(std::vector<CRGB> &leds, CRGB color) {
-    std::random_device random_device;
-    std::mt19937 random_number_generator(random_device());
 
-    unsigned numOfColsToLightUp = (*probabilityDistribution_)(random_number_generator);
+    unsigned numOfColsToLightUp = (*probabilityDistribution_)(randomGenerator_);
     unsigned numOfFlashes = random(1, 20);
     unsigned columnIndexWithInvertedColor = random(0, columnCount_);
     for (unsigned i = 0; i < numOfFlashes; i++) {
         auto columnsToLightUp = sampleColumns(numOfColsToLightUp);
+        uint8_t paletteStartIndex = getPaletteIndexForTime();
         for (unsigned columnIndex = 0; columnIndex < columnsToLightUp.size(); columnIndex++) {
+            if (palette_) {
+                // Use the opposite half of the palette instead of the inverted color
+                uint8_t offset = columnIndex == columnIndexWithInvertedColor ? 128 : 0;
+                lightUpColumnFromPalette(leds, columnsToLightUp[columnIndex], paletteStartIndex + offset, false);
+                continue;
+            }
             auto colorToShow = color;
             if (columnIndex == columnIndexWithInvertedColor) {
                 colorToShow = invertColor(color);
             }
-            lightUpColumn(leds, columnsToLightUp[columnIndex], colorToShow);
+            lightUpColumn(leds, columnsToLightUp[columnIndex], colorToShow, false);
         }
-        FastLED.show();
         unsigned onDuration = random(minOnDurationMs_, maxOnDurationMs_ + 1);
-        delay(onDuration);
-        FastLED.clear(true);
-        delay(onDuration);
+        showForEffectiveDuration(onDuration);
+        FastLED.clear(false);
+        showForEffectiveDuration(onDuration);
     }
-    FastLED.clear(true);
     unsigned offDuration = random(minOffDurationMs_, maxOffDurationMs_ + 1);
     return offDuration;
 }
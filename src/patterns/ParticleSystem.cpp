@@ -0,0 +1,80 @@
+#include "patterns/ParticleSystem.hpp"
+
+#include <cmath>
+
+namespace Pattern {
+// Particles below this intensity would be rendered completely dark
+const float MIN_VISIBLE_INTENSITY = 1.0f / 255;
+
+ParticleSystem::ParticleSystem(unsigned capacity)
+    : capacity_(capacity), position_(capacity), velocity_(capacity), length_(capacity), intensity_(capacity),
+      decay_(capacity), column_(capacity) {}
+
+void ParticleSystem::init(unsigned rowCount, unsigned columnCount) {
+    rowCount_ = rowCount;
+    columnCount_ = columnCount;
+    clear();
+}
+
+bool ParticleSystem::spawn(unsigned column, float position, float velocity, float length, float intensity,
+                           float decay) {
+    if (size_ == capacity_ || column >= columnCount_) {
+        return false;
+    }
+    position_[size_] = position;
+    velocity_[size_] = velocity;
+    length_[size_] = length;
+    intensity_[size_] = intensity;
+    decay_[size_] = 1 - decay;
+    column_[size_] = column;
+    size_++;
+    return true;
+}
+
+void ParticleSystem::update() {
+    // Separate loops without branches, so that the compiler can keep each of them tight
+    for (unsigned i = 0; i < size_; i++) {
+        position_[i] += velocity_[i];
+    }
+    for (unsigned i = 0; i < size_; i++) {
+        intensity_[i] *= decay_[i];
+    }
+    // Iterate backwards so that remove() only moves particles that have already been checked
+    for (unsigned i = size_; i-- > 0;) {
+        if (position_[i] + length_[i] <= 0 || position_[i] >= rowCount_ || intensity_[i] < MIN_VISIBLE_INTENSITY) {
+            remove(i);
+        }
+    }
+}
+
+void ParticleSystem::render(std::vector<CRGB> &leds, CRGB color, bool flipVertically) const {
+    render(color, flipVertically, [&leds](unsigned pixelIndex, CRGB scaledColor) { leds[pixelIndex] |= scaledColor; });
+}
+
+void ParticleSystem::clear() { size_ = 0; }
+
+void ParticleSystem::getPixelRange(unsigned particle, unsigned &startIndex, unsigned &endIndex,
+                                   bool flipVertically) const {
+    int startRow = min((int)rowCount_, max(0, (int)std::floor(position_[particle])));
+    int endRow = min((int)rowCount_, max(startRow, (int)std::ceil(position_[particle] + length_[particle])));
+    if (flipVertically) {
+        int flippedStartRow = rowCount_ - endRow;
+        endRow = rowCount_ - startRow;
+        startRow = flippedStartRow;
+    }
+    const unsigned columnOffset = column_[particle] * rowCount_;
+    startIndex = columnOffset + startRow;
+    endIndex = columnOffset + endRow;
+}
+
+void ParticleSystem::remove(unsigned particle) {
+    // Order doesn't matter, so fill the gap with the last particle
+    size_--;
+    position_[particle] = position_[size_];
+    velocity_[particle] = velocity_[size_];
+    length_[particle] = length_[size_];
+    intensity_[particle] = intensity_[size_];
+    decay_[particle] = decay_[size_];
+    column_[particle] = column_[size_];
+}
+};  // namespace Pattern
@@ -0,0 +1,62 @@
+#pragma once
+
+#define FASTLED_ESP32_I2S  // Alternative parallel output driver
+#include "FastLED.h"
+#include <vector>
+
+namespace Pattern {
+// Fixed-capacity pool of particles, i.e. line segments that move along a column and fade out over time.
+// The state is laid out as structure-of-arrays, so that update() and render() are tight loops over contiguous memory.
+// All memory is allocated in the constructor, spawning and updating particles never allocates.
+class ParticleSystem {
+   public:
+    explicit ParticleSystem(unsigned capacity);
+    void init(unsigned rowCount, unsigned columnCount);
+
+    // Position and length are measured in pixels from the start of the column, velocity in pixels per frame.
+    // The intensity is multiplied by (1 - decay) on every update.
+    // Returns false if the pool is full.
+    bool spawn(unsigned column, float position, float velocity, float length, float intensity = 1, float decay = 0);
+    // Moves and fades all particles by one frame and removes those that have left their column or faded out.
+    void update();
+    // Draws all particles, keeping the brighter value per channel where particles overlap.
+    void render(std::vector<CRGB> &leds, CRGB color, bool flipVertically = false) const;
+    // Calls writePixel(pixelIndex, scaledColor) for every pixel covered by a particle
+    template <typename PixelWriter> void render(CRGB color, bool flipVertically, PixelWriter writePixel) const {
+        for (unsigned i = 0; i < size_; i++) {
+            CRGB scaledColor = color;
+            scaledColor.nscale8_video(min(intensity_[i], 1.0f) * 255);
+            unsigned startIndex, endIndex;
+            getPixelRange(i, startIndex, endIndex, flipVertically);
+            for (unsigned pixelIndex = startIndex; pixelIndex < endIndex; pixelIndex++) {
+                writePixel(pixelIndex, scaledColor);
+            }
+        }
+    }
+    void clear();
+
+    unsigned size() const { return size_; }
+    unsigned capacity() const { return capacity_; }
+    float getPosition(unsigned particle) const { return position_[particle]; }
+    void setPosition(unsigned particle, float position) { position_[particle] = position; }
+    void setIntensity(unsigned particle, float intensity) { intensity_[particle] = intensity; }
+    // Pixel indices [startIndex, endIndex) covered by the particle, clipped to its column
+    void getPixelRange(unsigned particle, unsigned &startIndex, unsigned &endIndex,
+                       bool flipVertically = false) const;
+
+   private:
+    const unsigned capacity_;
+    unsigned size_{0};
+    unsigned rowCount_{0};
+    unsigned columnCount_{0};
+
+    std::vector<float> position_;
+    std::vector<float> velocity_;
+    std::vector<float> length_;
+    std::vector<float> intensity_;
+    std::vector<float> decay_;
+    std::vector<uint16_t> column_;
+
+    void remove(unsigned particle);
+};
+};  // namespace Pattern
@@ -8,12 +8,10 @@ void RandomSegments::init(unsigned rowCount, unsigned columnCount) {
 }
 
 unsigned RandomSegments::perform(std::vector<CRGB> &leds, CRGB color) {
-    std::random_device random_device;
-    std::mt19937 random_number_generator(random_device());
-    unsigned numOfColsToLightUp = (*probabilityDistribution_)(random_number_generator);
+    unsigned numOfColsToLightUp = (*probabilityDistribution_)(randomGenerator_);
     // Switch up color in 10 percent of cases
     if (random(0, 100) < 10) {
-        color = color ^ random(0xffffff + 1);
+        color = varyColor(color);
     }
     for (unsigned i = 0; i < numOfColsToLightUp; i++) {
         unsigned columnToLightUp = random(columnCount_);
@@ -26,10 +24,10 @@ unsigned RandomSegments::perform(std::vector<CRGB> &leds, CRGB color) {
             leds[j] = color;
         }
     }
-    FastLED.show();
     unsigned onDuration = random(minOnDurationMs_, maxOnDurationMs_ + 1);
-    delay(onDuration);
-    FastLED.clear(true);
+    showForEffectiveDuration(onDuration);
+    FastLED.clear(false);
+    showForEffectiveDuration(0);
     unsigned offDuration = random(minOffDurationMs_, maxOffDurationMs_ + 1);
     return offDuration;
 }
@@ -4,11 +4,16 @@ namespace Pattern {
 unsigned RandomSequence::perform(std::vector<CRGB> &leds, CRGB color) {
     auto columnsToLightUp = sampleColumns(columnCount_);
     for (unsigned i = 0; i < columnsToLightUp.size(); i++) {
-        lightUpColumn(leds, columnsToLightUp[i], color);
+        if (palette_) {
+            lightUpColumnFromPalette(leds, columnsToLightUp[i], getPaletteIndexForTime(), false);
+        } else {
+            lightUpColumn(leds, columnsToLightUp[i], color, false);
+        }
         unsigned onDuration = random(30, 60);
-        delay(onDuration);
-        FastLED.clear(true);
+        showForEffectiveDuration(onDuration);
+        FastLED.clear(false);
     }
+    showForEffectiveDuration(0);
     unsigned offDuration = random(700, 3000);
     return offDuration;
 }
@@ -8,20 +8,24 @@ void SingleStrobeFlash::init(unsigned rowCount, unsigned columnCount) {
 }
 
 unsigned SingleStrobeFlash::perform(std::vector<CRGB> &leds, CRGB color) {
-    std::random_device random_device;
-    std::mt19937 random_number_generator(random_device());
-    unsigned numOfColsToLightUp = (*probabilityDistribution_)(random_number_generator);
+    unsigned numOfColsToLightUp = (*probabilityDistribution_)(randomGenerator_);
     // Switch up color in 10 percent of cases
     if (sampleBernoulli(0.1)) {
-        color = color ^ random(0xffffff + 1);
+        color = varyColor(color);
     }
     auto columnsToLightUp = sampleColumns(numOfColsToLightUp);
+    uint8_t paletteStartIndex = getPaletteIndexForTime();
     for (unsigned i = 0; i < columnsToLightUp.size(); i++) {
-        lightUpColumn(leds, columnsToLightUp[i], color);
+        if (palette_) {
+            lightUpColumnFromPalette(leds, columnsToLightUp[i], paletteStartIndex, false);
+        } else {
+            lightUpColumn(leds, columnsToLightUp[i], color, false);
+        }
     }
     unsigned onDuration = random(minOnDurationMs_, maxOnDurationMs_ + 1);
-    delay(onDuration);
-    FastLED.clear(true);
+    showForEffectiveDuration(onDuration);
+    FastLED.clear(false);
+    showForEffectiveDuration(0);
     unsigned offDuration = random(minOffDurationMs_, maxOffDurationMs_ + 1);
     return offDuration;
 }
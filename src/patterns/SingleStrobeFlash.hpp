@@ -8,6 +8,7 @@ class SingleStrobeFlash : public AbstractPattern {
     SingleStrobeFlash() : AbstractPattern(){};
     unsigned perform(std::vector<CRGB> &leds, CRGB color) override;
     void init(unsigned rowCount, unsigned columnCount) override;
+    bool isTriggeredByOnsets() const override { return true; }
 
    private:
     std::shared_ptr<std::discrete_distribution<int>> probabilityDistribution_;
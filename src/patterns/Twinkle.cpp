@@ -1,23 +1,38 @@
 #include "patterns/Twinkle.hpp"
 
 namespace Pattern {
-unsigned Twinkle::perform(std::vector<CRGB> &leds, CRGB color) {
+void Twinkle::init(unsigned rowCount, unsigned columnCount) {
+    AbstractPattern::init(rowCount, columnCount);
+    spots_.init(rowCount, columnCount);
+}
 
+unsigned Twinkle::perform(std::vector<CRGB> &leds, CRGB color) {
     unsigned ledCount = rowCount_ * columnCount_;
-    unsigned spotCount = random(5, 50);
+    unsigned spotCount = random(5, MAX_SPOT_COUNT_);
+    if (audioFeatures_.isActive) {
+        // Follow the highs instead
+        spotCount = 5 + (MAX_SPOT_COUNT_ - 5) * audioFeatures_.bandLevels[Audio::AudioFeatures::HIGHS] / 255;
+    }
     for (unsigned i = 0; i < spotCount; i++) {
-        unsigned pixelIndex = random(ledCount);
+        unsigned columnIndex, rowIndex;
+        indexToCoordinates(random(ledCount), columnIndex, rowIndex);
         // Always light up chosen pixel
-        leds[pixelIndex] = color;
+        float position = rowIndex;
+        float length = 1;
         // Light up neighboring pixels with 50% probability each
         if (sampleBernoulli(0.5)) {
-            leds[(pixelIndex - 1) % (ledCount)] = color;
+            position -= 1;
+            length += 1;
         }
         if (sampleBernoulli(0.5)) {
-            leds[(pixelIndex + 1) % ledCount] = color;
+            length += 1;
         }
+        // Spots don't move and only last for a single frame
+        spots_.spawn(columnIndex, position, 0, length, 1, 1);
     }
-    FastLED.show();
+    spots_.render(leds, color);
+    spots_.update();
+    showImmediately();
     unsigned offDuration = random(0, 2);
     return offDuration;
 }
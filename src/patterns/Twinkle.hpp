@@ -1,13 +1,17 @@
 #pragma once
 
 #include "patterns/AbstractPattern.hpp"
+#include "patterns/ParticleSystem.hpp"
 
 namespace Pattern {
 class Twinkle : public AbstractPattern {
    public:
-    Twinkle() : AbstractPattern(){};
+    Twinkle() : AbstractPattern(), spots_(MAX_SPOT_COUNT_){};
     unsigned perform(std::vector<CRGB> &leds, CRGB color) override;
+    void init(unsigned rowCount, unsigned columnCount) override;
 
    private:
+    static const unsigned MAX_SPOT_COUNT_ = 50;
+    ParticleSystem spots_;
 };
 };  // namespace Pattern
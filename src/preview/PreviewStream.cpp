@@ -0,0 +1,147 @@
+#include "preview/PreviewStream.hpp"
+
+#include <Arduino.h>
+#include <algorithm>
+#include <esp_timer.h>
+
+namespace Preview {
+namespace {
+const uint8_t KEY_FRAME = 0;
+const uint8_t DELTA_FRAME = 1;
+
+inline uint16_t toRgb444(uint32_t red, uint32_t green, uint32_t blue) {
+    return ((red >> 4) << 8) | ((green >> 4) << 4) | (blue >> 4);
+}
+
+inline void appendUint16(std::vector<uint8_t> &message, uint16_t value) {
+    message.push_back(value & 0xff);
+    message.push_back(value >> 8);
+}
+}  // namespace
+
+PreviewStream::PreviewStream(const char *url) : webSocket_(url) {
+    webSocket_.onEvent([this](AsyncWebSocket *, AsyncWebSocketClient *client, AwsEventType type, void *argument,
+                              uint8_t *, size_t length) { onEvent(*client, type, argument, length); });
+}
+
+void PreviewStream::init(unsigned rowCount, unsigned columnCount) {
+    std::lock_guard<std::mutex> lockGuard(snapshotMutex_);
+    rowCount_ = rowCount;
+    columnCount_ = columnCount;
+    snapshot_.assign(columnCount * SEGMENTS_PER_COLUMN, 0);
+}
+
+void PreviewStream::capture(const std::vector<CRGB> &leds) {
+    if (!isSnapshotWanted_) {
+        return;
+    }
+    // The web server only holds the lock while copying the snapshot, skip this frame rather than waiting for it
+    std::unique_lock<std::mutex> lock(snapshotMutex_, std::try_to_lock);
+    if (!lock.owns_lock()) {
+        return;
+    }
+    const int64_t startUs = esp_timer_get_time();
+    for (unsigned column = 0; column < columnCount_; column++) {
+        const CRGB *pixels = &leds[column * rowCount_];
+        for (unsigned segment = 0; segment < SEGMENTS_PER_COLUMN; segment++) {
+            const unsigned startRow = rowCount_ * segment / SEGMENTS_PER_COLUMN;
+            const unsigned endRow = rowCount_ * (segment + 1) / SEGMENTS_PER_COLUMN;
+            uint32_t red = 0, green = 0, blue = 0;
+            for (unsigned row = startRow; row < endRow; row++) {
+                red += pixels[row].r;
+                green += pixels[row].g;
+                blue += pixels[row].b;
+            }
+            const unsigned rowCount = max(endRow - startRow, 1u);
+            snapshot_[column * SEGMENTS_PER_COLUMN + segment] =
+                toRgb444(red / rowCount, green / rowCount, blue / rowCount);
+        }
+    }
+    isSnapshotWanted_ = false;
+    const uint32_t durationUs = esp_timer_get_time() - startUs;
+    captureCount_++;
+    if (durationUs > maxCaptureDurationUs_) {
+        maxCaptureDurationUs_ = durationUs;
+    }
+}
+
+std::string PreviewStream::getStatistics() const {
+    std::string statistics = "preview clients: " + std::to_string(clientCount_) + " (" +
+                             std::to_string(droppedClientCount_) + " dropped)\n";
+    statistics += "preview snapshots: " + std::to_string(captureCount_) +
+                  ", max capture duration: " + std::to_string(maxCaptureDurationUs_) + " us\n";
+    return statistics;
+}
+
+void PreviewStream::onEvent(AsyncWebSocketClient &webSocketClient, AwsEventType type, void *argument, size_t length) {
+    const uint32_t id = webSocketClient.id();
+    if (type == WS_EVT_CONNECT) {
+        clients_.push_back({id, {}});
+        // Closes the oldest clients beyond the library's limit
+        webSocket_.cleanupClients();
+    } else if (type == WS_EVT_DISCONNECT) {
+        clients_.erase(std::remove_if(clients_.begin(), clients_.end(),
+                                      [id](const Client &client) { return client.id == id; }),
+                       clients_.end());
+    } else if (type == WS_EVT_DATA) {
+        // A request is complete with the last part of its message
+        const AwsFrameInfo &frameInfo = *static_cast<AwsFrameInfo *>(argument);
+        if (frameInfo.final && frameInfo.index + length == frameInfo.len) {
+            sendFrame(webSocketClient);
+        }
+    }
+    clientCount_ = clients_.size();
+}
+
+void PreviewStream::sendFrame(AsyncWebSocketClient &webSocketClient) {
+    auto client = std::find_if(clients_.begin(), clients_.end(),
+                               [&webSocketClient](const Client &client) { return client.id == webSocketClient.id(); });
+    if (client == clients_.end()) {
+        return;
+    }
+    // Clients only request the next frame after receiving the previous one, so their queue only fills up if they
+    // don't follow the protocol or the connection stalls
+    if (!webSocketClient.canSend()) {
+        webSocketClient.close();
+        droppedClientCount_++;
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lockGuard(snapshotMutex_);
+        segments_ = snapshot_;
+    }
+    isSnapshotWanted_ = true;
+    encode(*client, segments_, message_);
+    webSocketClient.binary(message_.data(), message_.size());
+}
+
+void PreviewStream::encode(Client &client, const std::vector<uint16_t> &segments, std::vector<uint8_t> &message) {
+    bool isKeyFrame = client.sentSegments.size() != segments.size();
+    unsigned changeCount = 0;
+    if (!isKeyFrame) {
+        for (unsigned i = 0; i < segments.size(); i++) {
+            changeCount += segments[i] != client.sentSegments[i];
+        }
+        // Each change takes twice the space of a segment in a key frame
+        isKeyFrame = 2 * changeCount >= segments.size();
+    }
+    message.clear();
+    message.push_back(isKeyFrame ? KEY_FRAME : DELTA_FRAME);
+    appendUint16(message, columnCount_);
+    message.push_back(SEGMENTS_PER_COLUMN);
+    if (isKeyFrame) {
+        for (uint16_t segment : segments) {
+            appendUint16(message, segment);
+        }
+    } else {
+        appendUint16(message, changeCount);
+        for (unsigned i = 0; i < segments.size(); i++) {
+            if (segments[i] != client.sentSegments[i]) {
+                appendUint16(message, i);
+                appendUint16(message, segments[i]);
+            }
+        }
+    }
+    client.sentSegments = segments;
+}
+};  // namespace Preview
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "ESPAsyncWebServer.h"
+#define FASTLED_ESP32_I2S  // Alternative parallel output driver
+#include "FastLED.h"
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Preview {
+// Streams a downsampled view of the shown frames to browsers over a WebSocket.
+// Each column is divided into SEGMENTS_PER_COLUMN segments, whose average color is quantized to 12 bits (RGB444).
+// Browsers request each frame by sending a message of any content, and request the next one once they have received
+// it, so that slow connections get fewer frames instead of a backlog. At most one request per client may be
+// outstanding, clients whose send queue fills up anyway are disconnected.
+// Frames are binary and little endian: a header of type (uint8, 0 = key frame, 1 = delta frame), column count
+// (uint16) and segments per column (uint8). Key frames continue with the color (uint16) of every segment, column by
+// column, delta frames with the number of changes (uint16, may be 0) and the index and color (uint16 each) of every
+// segment that has changed since the previous frame sent to the same client.
+//
+// Threading: AsyncWebSocket and its clients are only used from the WebSocket's event handler, which runs on the web
+// server's task (async_tcp). The library deletes clients on that task without locking, so it is the only task that
+// may call into it, and the per-client state in clients_ needs no lock either. The show loop and the web server only
+// share the snapshot under snapshotMutex_, which is never held while calling into the library, and which the show
+// loop only tries to take. So there is no lock ordering between the two, and the show loop never waits for the web
+// server.
+class PreviewStream {
+   public:
+    PreviewStream(const char *url = "/preview");
+    void init(unsigned rowCount, unsigned columnCount);
+    // Must be added to the web server
+    AsyncWebSocket &getWebSocket() { return webSocket_; }
+    // Called by the show loop with every frame. Only takes a snapshot if a client has requested a new one since the
+    // last snapshot and never waits for the web server.
+    void capture(const std::vector<CRGB> &leds);
+    // May be called from any thread
+    std::string getStatistics() const;
+
+    static const unsigned SEGMENTS_PER_COLUMN = 8;
+
+   private:
+    struct Client {
+        uint32_t id;
+        // Segments as last sent to the client, empty if it needs a key frame
+        std::vector<uint16_t> sentSegments;
+    };
+
+    AsyncWebSocket webSocket_;
+    unsigned rowCount_{0};
+    unsigned columnCount_{0};
+
+    std::vector<uint16_t> snapshot_;
+    std::mutex snapshotMutex_;
+    std::atomic_bool isSnapshotWanted_{false};
+
+    // Only accessed by the web server's task
+    std::vector<Client> clients_;
+    std::vector<uint16_t> segments_;
+    std::vector<uint8_t> message_;
+
+    std::atomic<uint32_t> captureCount_{0};
+    std::atomic<uint32_t> maxCaptureDurationUs_{0};
+    std::atomic<uint32_t> clientCount_{0};
+    std::atomic<uint32_t> droppedClientCount_{0};
+
+    // Called by the web server's task
+    void onEvent(AsyncWebSocketClient &webSocketClient, AwsEventType type, void *argument, size_t length);
+    void sendFrame(AsyncWebSocketClient &webSocketClient);
+    void encode(Client &client, const std::vector<uint16_t> &segments, std::vector<uint8_t> &message);
+};
+};  // namespace Preview
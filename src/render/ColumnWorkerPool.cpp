@@ -0,0 +1,81 @@
+#include "render/ColumnWorkerPool.hpp"
+
+#include <esp_pthread.h>
+
+namespace Render {
+ColumnWorkerPool::ColumnWorkerPool(unsigned workerCount, int core) {
+    // Threads are created with the pthread config of the creating thread, which is restored afterwards
+    esp_pthread_cfg_t previousConfig;
+    const bool hasPreviousConfig = esp_pthread_get_cfg(&previousConfig) == ESP_OK;
+    esp_pthread_cfg_t config = hasPreviousConfig ? previousConfig : esp_pthread_get_default_config();
+    config.pin_to_core = core;
+    config.thread_name = "render";
+    ESP_ERROR_CHECK(esp_pthread_set_cfg(&config));
+    for (unsigned i = 0; i < workerCount; i++) {
+        workers_.emplace_back(&ColumnWorkerPool::runWorker, this, i);
+    }
+    if (!hasPreviousConfig) {
+        previousConfig = esp_pthread_get_default_config();
+    }
+    ESP_ERROR_CHECK(esp_pthread_set_cfg(&previousConfig));
+}
+
+ColumnWorkerPool::~ColumnWorkerPool() {
+    {
+        std::lock_guard<std::mutex> lockGuard(mutex_);
+        stop_ = true;
+    }
+    workAvailable_.notify_all();
+    for (auto &worker : workers_) {
+        worker.join();
+    }
+}
+
+void ColumnWorkerPool::parallelForColumns(unsigned columnCount,
+                                          const std::function<void(unsigned, unsigned)> &render) {
+    if (workers_.empty() || columnCount < 2) {
+        render(0, columnCount);
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lockGuard(mutex_);
+        render_ = &render;
+        columnCount_ = columnCount;
+        busyWorkerCount_ = workers_.size();
+        generation_++;
+    }
+    workAvailable_.notify_all();
+    renderShare(0);
+    // Barrier: the frame must not be shown before all columns are rendered
+    std::unique_lock<std::mutex> lock(mutex_);
+    workDone_.wait(lock, [this] { return busyWorkerCount_ == 0; });
+}
+
+void ColumnWorkerPool::runWorker(unsigned workerIndex) {
+    unsigned renderedGeneration = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            workAvailable_.wait(lock, [&] { return stop_ || generation_ != renderedGeneration; });
+            if (stop_) {
+                return;
+            }
+            renderedGeneration = generation_;
+        }
+        renderShare(workerIndex + 1);
+        std::lock_guard<std::mutex> lockGuard(mutex_);
+        if (--busyWorkerCount_ == 0) {
+            workDone_.notify_one();
+        }
+    }
+}
+
+void ColumnWorkerPool::renderShare(unsigned threadIndex) {
+    const unsigned threadCount = getThreadCount();
+    const unsigned firstColumn = columnCount_ * threadIndex / threadCount;
+    const unsigned endColumn = columnCount_ * (threadIndex + 1) / threadCount;
+    if (firstColumn < endColumn) {
+        (*render_)(firstColumn, endColumn);
+    }
+}
+};  // namespace Render
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Render {
+// Persistent threads that render disjoint ranges of columns of the same frame in parallel.
+// Pixels are stored column by column and lights are independent of each other, so rendering needs no locking as long
+// as each range only touches pixels and pattern state of its own columns.
+class ColumnWorkerPool {
+   public:
+    // The thread calling parallelForColumns() takes part in the work, so a single worker already renders on two cores
+    ColumnWorkerPool(unsigned workerCount, int core = 0);
+    ~ColumnWorkerPool();
+    ColumnWorkerPool(const ColumnWorkerPool &) = delete;
+    ColumnWorkerPool &operator=(const ColumnWorkerPool &) = delete;
+
+    // Calls render(firstColumn, endColumn) for disjoint ranges that cover [0, columnCount) and returns once all
+    // ranges are rendered. Must not be called by more than one thread at a time.
+    void parallelForColumns(unsigned columnCount, const std::function<void(unsigned, unsigned)> &render);
+    unsigned getThreadCount() const { return workers_.size() + 1; }
+
+   private:
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable workAvailable_;
+    std::condition_variable workDone_;
+    // Work of the current frame, only written while all workers are idle
+    const std::function<void(unsigned, unsigned)> *render_{nullptr};
+    unsigned columnCount_{0};
+    unsigned generation_{0};
+    unsigned busyWorkerCount_{0};
+    bool stop_{false};
+
+    void runWorker(unsigned workerIndex);
+    void renderShare(unsigned threadIndex);
+};
+};  // namespace Render
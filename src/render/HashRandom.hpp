@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Render {
+// Stateless random numbers for parallelForColumns(): the same seed and counter always give the same number, no matter
+// which thread asks. Draw a seed per frame from the pattern's generator and use e.g. the pixel index as counter, so
+// that frames are reproducible and independent of how columns are split among threads.
+inline uint32_t hashRandom(uint32_t seed, uint32_t counter) {
+    // lowbias32 integer hash by Chris Wellons
+    uint32_t x = seed ^ (counter * 0x9e3779b9);
+    x ^= x >> 16;
+    x *= 0x7feb352d;
+    x ^= x >> 15;
+    x *= 0x846ca68b;
+    x ^= x >> 16;
+    return x;
+}
+};  // namespace Render
@@ -0,0 +1,61 @@
+#include "render/Quantizer.hpp"
+
+#include <cmath>
+
+namespace Render {
+namespace {
+// The gamma table has 2^GAMMA_TABLE_BITS entries, which is precise enough for 8 bit output with dithering
+const unsigned GAMMA_TABLE_BITS = 12;
+
+inline uint8_t quantize(uint16_t value, const uint16_t *gammaTable, uint32_t brightnessScale, uint8_t &error) {
+    // 8.8 fixed point level: gamma corrected value scaled by brightness, plus what previous frames haven't shown
+    const uint32_t level = (gammaTable[value >> (16 - GAMMA_TABLE_BITS)] * brightnessScale >> 8) + error;
+    error = level & 0xff;
+    return min(level >> 8, (uint32_t)255);
+}
+}  // namespace
+
+Quantizer::Quantizer() : gammaTable_(1 << GAMMA_TABLE_BITS) { setGamma(1); }
+
+void Quantizer::init(unsigned pixelCount) {
+    errors_.resize(3 * pixelCount);
+    resetErrors();
+}
+
+void Quantizer::setBrightness(uint8_t brightness) {
+    // Scaling by brightness + 1 keeps 255 exact, but would let the carried errors light up pixels at brightness 0
+    brightnessScale_ = brightness ? brightness + 1 : 0;
+    if (brightness == 0) {
+        resetErrors();
+    }
+}
+
+void Quantizer::setGamma(float gamma) {
+    // Entry i stands for the value i << (16 - GAMMA_TABLE_BITS) and maps it to itself with a gamma of 1, so that
+    // 8 bit levels stay exact and aren't dithered
+    const float tableSize = gammaTable_.size();
+    for (unsigned i = 0; i < gammaTable_.size(); i++) {
+        gammaTable_[i] = min(std::lround(std::pow(i / tableSize, gamma) * 65536), (long)UINT16_MAX);
+    }
+}
+
+void Quantizer::convert(const std::vector<Rgb16> &highDepthLeds, std::vector<CRGB> &leds) {
+    const uint16_t *gammaTable = gammaTable_.data();
+    const uint32_t brightnessScale = brightnessScale_;
+    uint8_t *errors = errors_.data();
+    for (unsigned i = 0; i < leds.size(); i++) {
+        const Rgb16 &pixel = highDepthLeds[i];
+        leds[i].r = quantize(pixel.r, gammaTable, brightnessScale, errors[3 * i]);
+        leds[i].g = quantize(pixel.g, gammaTable, brightnessScale, errors[3 * i + 1]);
+        leds[i].b = quantize(pixel.b, gammaTable, brightnessScale, errors[3 * i + 2]);
+    }
+}
+
+void Quantizer::resetErrors() {
+    // Start with different errors, so that neighboring pixels of the same level don't toggle in sync. Levels without
+    // a fraction are shown exactly from the first frame on, whatever the error.
+    for (unsigned i = 0; i < errors_.size(); i++) {
+        errors_[i] = i * 97;
+    }
+}
+};  // namespace Render
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "render/Rgb16.hpp"
+#include <vector>
+
+namespace Render {
+// Converts a 16 bit per channel led buffer to the 8 bit led buffer shown by FastLED in a single pass, which applies
+// gamma correction, global brightness and temporal dithering. The quantization error of each channel is carried over
+// to the next frame, so that levels between two 8 bit values are shown by alternating between them.
+// FastLED's own brightness scaling and dithering must be disabled while its output is shown.
+class Quantizer {
+   public:
+    Quantizer();
+    void init(unsigned pixelCount);
+    // 1 keeps values linear, about 2.2 matches the perceived brightness of WS2812 LEDs
+    void setGamma(float gamma);
+    // 0 turns all leds off, like FastLED.setBrightness(0)
+    void setBrightness(uint8_t brightness);
+    void convert(const std::vector<Rgb16> &highDepthLeds, std::vector<CRGB> &leds);
+
+   private:
+    // Indexed by the upper bits of each channel
+    std::vector<uint16_t> gammaTable_;
+    // Fraction of an 8 bit level per channel that has not been shown yet
+    std::vector<uint8_t> errors_;
+    uint32_t brightnessScale_{256};
+
+    void resetErrors();
+};
+};  // namespace Render
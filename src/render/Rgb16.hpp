@@ -0,0 +1,52 @@
+#pragma once
+
+#define FASTLED_ESP32_I2S  // Alternative parallel output driver
+#include "FastLED.h"
+#include <cstdint>
+
+namespace Render {
+// Pixel with 16 bits per channel. Patterns that draw into this keep the precision that 8 bit pixels lose when they
+// are faded or scaled repeatedly; it is quantized to 8 bits only when the frame is shown (see Quantizer).
+// Channels are 8.8 fixed point, i.e. the upper byte is the 8 bit level and the lower byte a fraction of a level.
+struct Rgb16 {
+    uint16_t r{0};
+    uint16_t g{0};
+    uint16_t b{0};
+
+    Rgb16(){};
+    Rgb16(uint16_t red, uint16_t green, uint16_t blue) : r(red), g(green), b(blue){};
+    // Same levels without a fraction, so that colors that aren't faded are shown without dithering
+    explicit Rgb16(CRGB color) : r(color.r << 8), g(color.g << 8), b(color.b << 8){};
+
+    // Scales all channels by scale / 65536
+    Rgb16 &nscale16(uint16_t scale) {
+        r = (uint32_t)r * scale >> 16;
+        g = (uint32_t)g * scale >> 16;
+        b = (uint32_t)b * scale >> 16;
+        return *this;
+    }
+    // Same as CRGB::fadeToBlackBy(), i.e. scales all channels by (256 - fadeAmount) / 256. Channels that fall below
+    // half an 8 bit level are turned off, so that fading pixels become dark after as many steps as 8 bit pixels.
+    Rgb16 &fadeToBlackBy(uint8_t fadeAmount) {
+        const uint32_t scale = 256 - fadeAmount;
+        r = fadeChannel(r, scale);
+        g = fadeChannel(g, scale);
+        b = fadeChannel(b, scale);
+        return *this;
+    }
+    // Keeps the brighter value per channel
+    Rgb16 &operator|=(const Rgb16 &other) {
+        r = max(r, other.r);
+        g = max(g, other.g);
+        b = max(b, other.b);
+        return *this;
+    }
+    explicit operator bool() const { return r || g || b; }
+
+   private:
+    static uint16_t fadeChannel(uint32_t value, uint32_t scale) {
+        value = value * scale >> 8;
+        return value < 0x80 ? 0 : value;
+    }
+};
+};  // namespace Render
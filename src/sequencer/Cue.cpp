@@ -0,0 +1,144 @@
+#include "sequencer/Cue.hpp"
+
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <vector>
+
+namespace Sequencer {
+namespace {
+// strtoul() and strtod() also accept whitespace, signs, hexadecimal numbers, exponents, "inf" and "nan", so tokens are
+// checked for plain digits first
+bool isUnsignedNumber(const std::string &token, int base) {
+    for (char character : token) {
+        if (!(base == 16 ? isxdigit((unsigned char)character) : isdigit((unsigned char)character))) {
+            return false;
+        }
+    }
+    return !token.empty();
+}
+
+// Plain decimal numbers such as "12", "1.5" or ".5", with an optional sign if isSigned
+bool isDecimalNumber(const std::string &token, bool isSigned) {
+    const size_t start = isSigned && (token[0] == '-' || token[0] == '+') ? 1 : 0;
+    bool hasDigits = false;
+    bool hasPoint = false;
+    for (size_t i = start; i < token.size(); i++) {
+        if (isdigit((unsigned char)token[i])) {
+            hasDigits = true;
+        } else if (token[i] == '.' && !hasPoint) {
+            hasPoint = true;
+        } else {
+            return false;
+        }
+    }
+    return hasDigits;
+}
+
+bool parseUnsigned(const std::string &token, uint32_t &value, int base, uint32_t maxValue) {
+    if (!isUnsignedNumber(token, base)) {
+        return false;
+    }
+    // Too many digits saturate at ULONG_MAX
+    unsigned long parsedValue = strtoul(token.c_str(), nullptr, base);
+    if (parsedValue > maxValue) {
+        return false;
+    }
+    value = parsedValue;
+    return true;
+}
+
+bool parseTime(const std::string &token, uint32_t &timeMs) {
+    const size_t colon = token.find(':');
+    uint32_t minutes = 0;
+    std::string seconds = token;
+    if (colon != std::string::npos) {
+        if (!parseUnsigned(token.substr(0, colon), minutes, 10, UINT32_MAX / 60000)) {
+            return false;
+        }
+        seconds = token.substr(colon + 1);
+    }
+    if (!isDecimalNumber(seconds, false)) {
+        return false;
+    }
+    const double secondsValue = strtod(seconds.c_str(), nullptr);
+    if (colon != std::string::npos && secondsValue >= 60) {
+        return false;
+    }
+    // Too many digits give infinity, which is rejected here as well
+    const double totalMs = (minutes * 60.0 + secondsValue) * 1000;
+    if (!(totalMs <= UINT32_MAX)) {
+        return false;
+    }
+    timeMs = std::lround(totalMs);
+    return true;
+}
+}  // namespace
+
+bool isBlankLine(const std::string &line) {
+    for (char character : line) {
+        if (character == '#') {
+            return true;
+        }
+        if (!isspace((unsigned char)character)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool parseCue(const std::string &line, Cue &cue, std::string &error) {
+    std::istringstream tokenStream(line.substr(0, line.find('#')));
+    std::vector<std::string> tokens;
+    std::string token;
+    while (tokenStream >> token) {
+        tokens.push_back(token);
+    }
+    if (tokens.size() < 2) {
+        error = "Expected a time and an event";
+        return false;
+    }
+    if (!parseTime(tokens[0], cue.timeMs)) {
+        error = "Invalid time '" + tokens[0] + "'";
+        return false;
+    }
+    const std::string &event = tokens[1];
+    const size_t argumentCount = tokens.size() - 2;
+    bool isValid = false;
+    if (event == "pattern" && argumentCount == 1) {
+        cue.type = CueType::PATTERN;
+        isValid = parseUnsigned(tokens[2], cue.value, 10, UINT16_MAX);
+    } else if (event == "color" && argumentCount == 1) {
+        cue.type = CueType::COLOR;
+        isValid = parseUnsigned(tokens[2], cue.value, 16, 0xffffff);
+    } else if (event == "brightness" && argumentCount == 1) {
+        cue.type = CueType::BRIGHTNESS;
+        isValid = parseUnsigned(tokens[2], cue.value, 10, 255);
+    } else if (event == "parameter" && argumentCount == 3) {
+        cue.type = CueType::PARAMETER;
+        isValid = parseUnsigned(tokens[2], cue.value, 10, UINT16_MAX) && isDecimalNumber(tokens[4], true) &&
+                  tokens[3].size() <= Cue::MAX_PARAMETER_NAME_LENGTH;
+        if (isValid) {
+            cue.parameterValue = strtof(tokens[4].c_str(), nullptr);
+            isValid = std::isfinite(cue.parameterValue);
+            // Including the terminating null character
+            memcpy(cue.parameterName, tokens[3].c_str(), tokens[3].size() + 1);
+        }
+    } else if (event == "blackout" && argumentCount == 0) {
+        cue.type = CueType::BLACKOUT;
+        isValid = true;
+    } else if (event == "loop" && argumentCount == 0) {
+        cue.type = CueType::LOOP;
+        isValid = true;
+    } else {
+        error = "Unknown event or wrong number of arguments: '" + event + "'";
+        return false;
+    }
+    if (!isValid) {
+        error = "Invalid arguments for '" + event + "'";
+    }
+    return isValid;
+}
+};  // namespace Sequencer
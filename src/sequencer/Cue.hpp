@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace Sequencer {
+enum class CueType : uint8_t { PATTERN, COLOR, BRIGHTNESS, PARAMETER, BLACKOUT, LOOP };
+
+// A timed event of a cue list. Each line of a cue list holds "<time> <event> [arguments]" or a "# comment", where
+// the time since the start of the cue list is given as "<seconds>" or "<minutes>:<seconds>" (e.g. "1:30.5"):
+//   <time> pattern <index>
+//   <time> color <rrggbb>
+//   <time> brightness <0-255>
+//   <time> parameter <pattern index> <name> <value>   (see AbstractPattern::setParameter())
+//   <time> blackout                                   (switches to the Blackout pattern)
+//   <time> loop                                       (starts over, with <time> as the new start)
+// Numbers are plain decimals like "2", "1.5" or "-0.25" (signs only for parameter values), colors are hexadecimal
+// without a prefix.
+struct Cue {
+    static const unsigned MAX_PARAMETER_NAME_LENGTH = 15;
+
+    uint32_t timeMs{0};
+    CueType type{CueType::BLACKOUT};
+    // Pattern index (PATTERN, PARAMETER), color as 0xrrggbb (COLOR) or brightness (BRIGHTNESS)
+    uint32_t value{0};
+    float parameterValue{0};
+    char parameterName[MAX_PARAMETER_NAME_LENGTH + 1] = {};
+};
+
+// Returns false and describes the problem in error if line is not a valid cue
+bool parseCue(const std::string &line, Cue &cue, std::string &error);
+// Whether line holds nothing but whitespace or a comment
+bool isBlankLine(const std::string &line);
+};  // namespace Sequencer
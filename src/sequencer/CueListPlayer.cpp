@@ -0,0 +1,150 @@
+#include "sequencer/CueListPlayer.hpp"
+
+#include <Arduino.h>
+
+namespace Sequencer {
+// Number of cues that are read ahead of time. Pattern changes can't happen faster than once per frame, so this covers
+// the densest sensible cue lists for far longer than the read-ahead takes.
+const unsigned READ_AHEAD_CUE_COUNT = 32;
+// Cues are due with this precision, it is well below a frame duration
+const uint32_t TICK_US = 2000;
+// 256 slots * 2 ms, one turn of the wheel takes about half a second
+const unsigned SLOT_COUNT = 256;
+// Bounds the time spent in a single call of advance(), e.g. for files with many invalid lines
+const unsigned MAX_LINES_PER_READ_AHEAD = 64;
+// Longer lines are invalid
+const size_t MAX_LINE_LENGTH = 120;
+
+CueListPlayer::CueListPlayer(std::function<void(const Cue &)> dispatch)
+    : dispatch_(dispatch), timerWheel_(READ_AHEAD_CUE_COUNT, SLOT_COUNT, TICK_US) {
+    line_.reserve(MAX_LINE_LENGTH);
+    fire_ = [this](const Cue &cue) {
+        dispatchCount_++;
+        dispatch_(cue);
+    };
+}
+
+bool CueListPlayer::start(fs::FS &fs, const char *path, int64_t nowUs) {
+    stop();
+    file_ = fs.open(path, "r");
+    if (!file_) {
+        return false;
+    }
+    startUs_ = nowUs;
+    timerWheel_.reset(nowUs);
+    rewind();
+    loopOffsetMs_ = 0;
+    loopCount_ = 0;
+    dispatchCount_ = 0;
+    invalidLineCount_ = 0;
+    isRunning_ = true;
+    readAhead();
+    return true;
+}
+
+void CueListPlayer::stop() {
+    if (file_) {
+        file_.close();
+    }
+    timerWheel_.reset(0);
+    isRunning_ = false;
+}
+
+void CueListPlayer::advance(int64_t nowUs) {
+    if (!isRunning_) {
+        return;
+    }
+    timerWheel_.advance(nowUs, fire_);
+    if (!isEndOfFile_ && !timerWheel_.isFull()) {
+        readAhead();
+    }
+    if (isEndOfFile_ && timerWheel_.getSize() == 0) {
+        Serial.println("Cue list finished");
+        stop();
+    }
+}
+
+std::string CueListPlayer::getStatus() const {
+    if (!isRunning_) {
+        return "Stopped after " + std::to_string(dispatchCount_) + " cues";
+    }
+    return "Playing, line " + std::to_string(lineNumber_) + ", loop " + std::to_string(loopCount_) + ", " +
+           std::to_string(dispatchCount_) + " cues dispatched, " + std::to_string(invalidLineCount_) +
+           " invalid lines";
+}
+
+void CueListPlayer::readAhead() {
+    std::string error;
+    Cue cue;
+    for (unsigned lineCount = 0; lineCount < MAX_LINES_PER_READ_AHEAD && !timerWheel_.isFull(); lineCount++) {
+        if (!readLine()) {
+            isEndOfFile_ = true;
+            return;
+        }
+        lineNumber_++;
+        if (isBlankLine(line_)) {
+            continue;
+        }
+        if (isLineTooLong_) {
+            error = "Line is longer than " + std::to_string(MAX_LINE_LENGTH) + " characters";
+        } else if (!parseCue(line_, cue, error)) {
+            // Fall through to the error below
+        } else if (cue.timeMs < previousTimeMs_) {
+            error = "Cue is earlier than the one before";
+        } else if (cue.type == CueType::LOOP) {
+            if (cue.timeMs == 0) {
+                error = "Loop at time 0";
+            } else {
+                // The cues of the next round are read right away, so that they don't wait for the loop to fire
+                loopOffsetMs_ += cue.timeMs;
+                loopCount_++;
+                rewind();
+                continue;
+            }
+        } else {
+            previousTimeMs_ = cue.timeMs;
+            timerWheel_.schedule(startUs_ + (int64_t)(loopOffsetMs_ + cue.timeMs) * 1000, cue);
+            continue;
+        }
+        invalidLineCount_++;
+        Serial.printf("Error. Cue list line %u: %s\n", lineNumber_.load(), error.c_str());
+    }
+}
+
+bool CueListPlayer::readLine() {
+    line_.clear();
+    isLineTooLong_ = false;
+    bool hasCharacters = false;
+    while (true) {
+        if (readPosition_ == readLength_) {
+            readLength_ = file_.read(reinterpret_cast<uint8_t *>(readBuffer_.data()), readBuffer_.size());
+            readPosition_ = 0;
+            if (readLength_ == 0) {
+                return hasCharacters;
+            }
+        }
+        const char character = readBuffer_[readPosition_++];
+        hasCharacters = true;
+        if (character == '\n') {
+            return true;
+        }
+        if (character == '\r') {
+            continue;
+        }
+        if (line_.size() < MAX_LINE_LENGTH) {
+            line_ += character;
+        } else {
+            isLineTooLong_ = true;
+        }
+    }
+}
+
+void CueListPlayer::rewind() {
+    file_.seek(0);
+    readPosition_ = 0;
+    readLength_ = 0;
+    isEndOfFile_ = false;
+    lineNumber_ = 0;
+    previousTimeMs_ = 0;
+}
+};  // namespace Sequencer
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "FS.h"
+#include "sequencer/Cue.hpp"
+#include "sequencer/TimerWheel.hpp"
+#include <array>
+#include <atomic>
+#include <functional>
+#include <string>
+
+namespace Sequencer {
+// Plays a cue list stored in a file (see Cue.hpp for the format), with the cues sorted by time. The file is streamed:
+// only the next few cues are read ahead into a timer wheel, so cue lists of any length play in constant memory.
+// Invalid lines are reported on the serial port and skipped.
+// All methods except getStatus() must be called from the same thread, which is the show loop in RaveLights.
+class CueListPlayer {
+   public:
+    explicit CueListPlayer(std::function<void(const Cue &)> dispatch);
+    // Plays the cue list at path, with its time 0 at nowUs. Returns false if the file could not be opened.
+    bool start(fs::FS &fs, const char *path, int64_t nowUs);
+    void stop();
+    // Dispatches the cues that are due at nowUs and reads ahead. Cheap enough to be called every millisecond.
+    void advance(int64_t nowUs);
+    bool isRunning() const { return isRunning_; }
+    // Human readable progress. May be called from any thread.
+    std::string getStatus() const;
+
+   private:
+    std::function<void(const Cue &)> dispatch_;
+    TimerWheel timerWheel_;
+    fs::File file_;
+    std::array<char, 128> readBuffer_;
+    size_t readPosition_{0};
+    size_t readLength_{0};
+    std::string line_;
+    bool isLineTooLong_{false};
+    bool isEndOfFile_{false};
+    int64_t startUs_{0};
+    // Time of the last loop relative to startUs_, added to the time of all cues read since
+    uint64_t loopOffsetMs_{0};
+    uint32_t previousTimeMs_{0};
+    // Passed on to the timer wheel, so that cues keep the order of the file if they fall into the same tick
+    std::function<void(const Cue &)> fire_;
+
+    std::atomic_bool isRunning_{false};
+    std::atomic<unsigned> lineNumber_{0};
+    std::atomic<unsigned> loopCount_{0};
+    std::atomic<unsigned> dispatchCount_{0};
+    std::atomic<unsigned> invalidLineCount_{0};
+
+    // Schedules cues until the timer wheel is full, the end of the file is reached or a line limit is hit
+    void readAhead();
+    // Returns false at the end of the file. Longer lines than MAX_LINE_LENGTH are truncated.
+    bool readLine();
+    void rewind();
+};
+};  // namespace Sequencer
@@ -0,0 +1,107 @@
+#include "sequencer/TimerWheel.hpp"
+
+#include <algorithm>
+
+namespace Sequencer {
+// Marks the end of a list of entries
+const int16_t NONE = -1;
+
+TimerWheel::TimerWheel(unsigned capacity, unsigned slotCount, uint32_t tickUs)
+    : TICK_US_(tickUs), entries_(capacity), slotHeads_(slotCount), slotTails_(slotCount) {
+    reset(0);
+}
+
+void TimerWheel::reset(int64_t nowUs) {
+    std::fill(slotHeads_.begin(), slotHeads_.end(), NONE);
+    std::fill(slotTails_.begin(), slotTails_.end(), NONE);
+    for (unsigned i = 0; i < entries_.size(); i++) {
+        entries_[i].next = i + 1 < entries_.size() ? i + 1 : NONE;
+    }
+    freeHead_ = entries_.empty() ? NONE : 0;
+    size_ = 0;
+    startUs_ = nowUs;
+    currentTick_ = 0;
+}
+
+bool TimerWheel::schedule(int64_t dueUs, const Cue &cue) {
+    if (freeHead_ == NONE) {
+        return false;
+    }
+    // Round up, so that a cue never fires before its time
+    uint64_t dueTick = dueUs > startUs_ ? (dueUs - startUs_ + TICK_US_ - 1) / TICK_US_ : 0;
+    if (dueTick < currentTick_) {
+        dueTick = currentTick_;
+    }
+    const unsigned slot = dueTick % slotHeads_.size();
+
+    const int16_t index = freeHead_;
+    Entry &entry = entries_[index];
+    freeHead_ = entry.next;
+    entry.cue = cue;
+    entry.remainingTurns = (dueTick - currentTick_) / slotHeads_.size();
+    entry.next = NONE;
+    if (slotTails_[slot] == NONE) {
+        slotHeads_[slot] = index;
+    } else {
+        entries_[slotTails_[slot]].next = index;
+    }
+    slotTails_[slot] = index;
+    size_++;
+    return true;
+}
+
+void TimerWheel::advance(int64_t nowUs, const std::function<void(const Cue &)> &fire) {
+    if (size_ == 0) {
+        // Nothing to fire, skip the elapsed ticks at once
+        if (nowUs >= startUs_ + (int64_t)(currentTick_ * TICK_US_)) {
+            currentTick_ = (nowUs - startUs_) / TICK_US_ + 1;
+        }
+        return;
+    }
+    while (nowUs >= startUs_ + (int64_t)(currentTick_ * TICK_US_)) {
+        const unsigned slot = currentTick_ % slotHeads_.size();
+        currentTick_++;
+        if (slotHeads_[slot] == NONE) {
+            continue;
+        }
+        // Unlink the due entries first, so that fire can schedule into any slot, including this one
+        int16_t dueHead = NONE;
+        int16_t dueTail = NONE;
+        int16_t previous = NONE;
+        int16_t index = slotHeads_[slot];
+        while (index != NONE) {
+            Entry &entry = entries_[index];
+            const int16_t next = entry.next;
+            if (entry.remainingTurns > 0) {
+                entry.remainingTurns--;
+                previous = index;
+            } else {
+                if (previous == NONE) {
+                    slotHeads_[slot] = next;
+                } else {
+                    entries_[previous].next = next;
+                }
+                entry.next = NONE;
+                if (dueTail == NONE) {
+                    dueHead = index;
+                } else {
+                    entries_[dueTail].next = index;
+                }
+                dueTail = index;
+            }
+            index = next;
+        }
+        slotTails_[slot] = previous;
+        while (dueHead != NONE) {
+            Entry &entry = entries_[dueHead];
+            const Cue cue = entry.cue;
+            const int16_t next = entry.next;
+            entry.next = freeHead_;
+            freeHead_ = dueHead;
+            size_--;
+            fire(cue);
+            dueHead = next;
+        }
+    }
+}
+};  // namespace Sequencer
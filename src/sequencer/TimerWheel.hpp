@@ -0,0 +1,46 @@
+#pragma once
+
+#include "sequencer/Cue.hpp"
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace Sequencer {
+// Hashed timer wheel holding cues until they are due. Time is divided into ticks, and each cue is hashed into one of
+// slotCount slots by its due tick, together with the number of turns of the wheel it has to wait. Scheduling a cue and
+// advancing by one tick take constant time, independent of the number of scheduled cues.
+// Entries come from a pool allocated once, so nothing is allocated while the show is running.
+class TimerWheel {
+   public:
+    TimerWheel(unsigned capacity, unsigned slotCount, uint32_t tickUs);
+    // Removes all cues and starts counting ticks at nowUs
+    void reset(int64_t nowUs);
+    // Returns false if the wheel is full. Cues that are already due fire on the next tick.
+    bool schedule(int64_t dueUs, const Cue &cue);
+    // Fires all cues that are due at nowUs, in the order of their due ticks and, within a tick, in the order they have
+    // been scheduled. fire may schedule further cues.
+    void advance(int64_t nowUs, const std::function<void(const Cue &)> &fire);
+    unsigned getSize() const { return size_; }
+    bool isFull() const { return freeHead_ < 0; }
+    uint32_t getTickUs() const { return TICK_US_; }
+
+   private:
+    struct Entry {
+        Cue cue;
+        uint32_t remainingTurns{0};
+        // Next entry in the same slot or in the free list
+        int16_t next{-1};
+    };
+
+    const uint32_t TICK_US_;
+    std::vector<Entry> entries_;
+    // First and last entry of each slot, so that cues of the same tick fire in order
+    std::vector<int16_t> slotHeads_;
+    std::vector<int16_t> slotTails_;
+    int16_t freeHead_{-1};
+    unsigned size_{0};
+    int64_t startUs_{0};
+    // The next tick to be processed, it is due at startUs_ + currentTick_ * TICK_US_
+    uint64_t currentTick_{0};
+};
+};  // namespace Sequencer
@@ -0,0 +1,28 @@
+#include "timing/Clock.hpp"
+
+#include <Arduino.h>
+#include <esp_timer.h>
+
+namespace Timing {
+int64_t RealClock::nowUs() { return esp_timer_get_time(); }
+
+void RealClock::sleepUntilUs(int64_t timeUs) {
+    // delay(n) yields to other tasks and returns after more than n - 1 but at most n ticks (1 ms), so it never
+    // oversleeps when n is rounded down. Only the last fraction of a tick is spent spinning.
+    int64_t remainingUs;
+    while ((remainingUs = timeUs - nowUs()) >= 1000) {
+        delay(remainingUs / 1000);
+    }
+    while (nowUs() < timeUs) {
+    }
+}
+
+void RealClock::yieldUs(uint32_t durationUs) { delay(durationUs < 1000 ? 1 : durationUs / 1000); }
+
+void VirtualClock::sleepUntilUs(int64_t timeUs) {
+    // Only move forward, even if another thread has already advanced the time past timeUs
+    int64_t currentTimeUs = timeUs_;
+    while (currentTimeUs < timeUs && !timeUs_.compare_exchange_weak(currentTimeUs, timeUs)) {
+    }
+}
+};  // namespace Timing
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace Timing {
+// Source of time for the show loop and patterns.
+// Patterns must use this instead of millis() and delay(), so that shows can run faster than real time.
+class Clock {
+   public:
+    virtual ~Clock(){};
+    virtual int64_t nowUs() = 0;
+    // Returns once nowUs() >= timeUs
+    virtual void sleepUntilUs(int64_t timeUs) = 0;
+    // Lets other tasks run for roughly durationUs, without the precision (and busy waiting) of sleepUntilUs()
+    virtual void yieldUs(uint32_t durationUs) = 0;
+
+    unsigned long nowMs() { return nowUs() / 1000; }
+    void delayMs(unsigned long durationMs) { sleepUntilUs(nowUs() + (int64_t)durationMs * 1000); }
+};
+
+// Microsecond timer of the ESP32
+class RealClock : public Clock {
+   public:
+    RealClock(){};
+    int64_t nowUs() override;
+    void sleepUntilUs(int64_t timeUs) override;
+    void yieldUs(uint32_t durationUs) override;
+};
+
+// Time only passes by sleeping or calling advanceUs(), so sleeping returns immediately.
+// Running a show with this clock takes as long as the computation and yields deterministic timestamps.
+class VirtualClock : public Clock {
+   public:
+    VirtualClock(int64_t startTimeUs = 0) : timeUs_(startTimeUs){};
+    int64_t nowUs() override { return timeUs_; }
+    void sleepUntilUs(int64_t timeUs) override;
+    void yieldUs(uint32_t durationUs) override { sleepUntilUs(nowUs() + durationUs); }
+    void advanceUs(int64_t durationUs) { timeUs_ += durationUs; }
+
+   private:
+    std::atomic<int64_t> timeUs_;
+};
+};  // namespace Timing
@@ -0,0 +1,111 @@
+#include "timing/FrameScheduler.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace Timing {
+// Upper bounds of the buckets of the lateness histogram. The last bucket holds everything above.
+const std::array<uint32_t, 8> LATENESS_BUCKET_LIMITS_US = {50, 100, 250, 500, 1000, 2000, 5000, 10000};
+
+// The earliest deadline that can still be met is one show() duration from now
+void FrameScheduler::resync() {
+    deadlineUs_ = now() + showDurationUs_;
+    isInterruptRequested_ = false;
+}
+
+void FrameScheduler::present(uint32_t durationUs) {
+    if (outputPass_) {
+        outputPass_();
+    }
+    clock_.sleepUntilUs(showStartUs());
+    show();
+    int64_t latenessUs = now() - deadlineUs_;
+    recordLateness(latenessUs);
+    if (latenessUs > (int64_t)MAX_LATENESS_US_) {
+        deadlineUs_ = now();
+        resyncCount_++;
+    }
+    deadlineUs_ += durationUs;
+}
+
+void FrameScheduler::presentImmediately() {
+    if (outputPass_) {
+        outputPass_();
+    }
+    show();
+    deadlineUs_ = now();
+}
+
+void FrameScheduler::hold(uint32_t durationUs) { deadlineUs_ += durationUs; }
+
+void FrameScheduler::waitForDeadline(uint32_t maxWaitUs) {
+    // Yielding may take up to a tick longer than requested, so it is only safe that far ahead of the deadline
+    if (showStartUs() - now() > (int64_t)maxWaitUs + 1000) {
+        clock_.yieldUs(maxWaitUs);
+    } else {
+        clock_.sleepUntilUs(showStartUs());
+    }
+}
+
+bool FrameScheduler::isDeadlineReached() const { return now() >= showStartUs(); }
+
+std::string FrameScheduler::getStatistics() const {
+    std::string statistics = "first frame at: " + std::to_string(firstFrameTimeUs_) + " us\n";
+    statistics += "frames: " + std::to_string(frameCount_) + "\n";
+    statistics += "missed (> " + std::to_string(MISS_TOLERANCE_US_) + " us late): " + std::to_string(missCount_) + "\n";
+    statistics += "resyncs: " + std::to_string(resyncCount_) + "\n";
+    statistics += "max lateness: " + std::to_string(maxLatenessUs_) + " us\n";
+    statistics += "last show() duration: " + std::to_string(lastShowDurationUs_) + " us\n";
+    statistics += "lateness histogram:\n";
+    uint32_t lowerLimitUs = 0;
+    for (unsigned i = 0; i < LATENESS_BUCKET_LIMITS_US.size(); i++) {
+        statistics += "  " + std::to_string(lowerLimitUs) + " - " + std::to_string(LATENESS_BUCKET_LIMITS_US[i]) +
+                      " us: " + std::to_string(latenessHistogram_[i]) + "\n";
+        lowerLimitUs = LATENESS_BUCKET_LIMITS_US[i];
+    }
+    statistics += "  > " + std::to_string(lowerLimitUs) + " us: " + std::to_string(latenessHistogram_.back()) + "\n";
+    return statistics;
+}
+
+void FrameScheduler::resetStatistics() {
+    for (auto &bucket : latenessHistogram_) {
+        bucket = 0;
+    }
+    frameCount_ = 0;
+    missCount_ = 0;
+    resyncCount_ = 0;
+    maxLatenessUs_ = 0;
+}
+
+void FrameScheduler::show() {
+    int64_t timeBeforeShow = now();
+    showFrame_();
+    int64_t showDurationUs = now() - timeBeforeShow;
+    if (firstFrameTimeUs_ < 0) {
+        firstFrameTimeUs_ = timeBeforeShow + showDurationUs;
+    }
+    if (showDurationUs_ == 0) {
+        showDurationUs_ = showDurationUs;
+    } else {
+        showDurationUs_ = (7 * showDurationUs_ + showDurationUs) / 8;
+    }
+    lastShowDurationUs_ = showDurationUs;
+}
+
+void FrameScheduler::recordLateness(int64_t latenessUs) {
+    // Frames that are latched early are just as wrong as late ones
+    uint32_t absoluteLatenessUs = std::min(std::abs(latenessUs), (int64_t)UINT32_MAX);
+    unsigned bucket = 0;
+    while (bucket < LATENESS_BUCKET_LIMITS_US.size() && absoluteLatenessUs > LATENESS_BUCKET_LIMITS_US[bucket]) {
+        bucket++;
+    }
+    latenessHistogram_[bucket]++;
+    frameCount_++;
+    if (latenessUs > (int64_t)MISS_TOLERANCE_US_) {
+        missCount_++;
+    }
+    if (absoluteLatenessUs > maxLatenessUs_) {
+        maxLatenessUs_ = absoluteLatenessUs;
+    }
+}
+};  // namespace Timing
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "timing/Clock.hpp"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace Timing {
+// Presents frames at absolute deadlines measured in microseconds. Each deadline is derived from the previous one
+// rather than from the time a frame was actually shown, so timing errors don't accumulate across frames.
+// The frame is sent out by showFrame, usually FastLED.show(), which is started early by its measured duration, so that
+// a frame is latched at its deadline. Tests pass a function that records the frames instead.
+class FrameScheduler {
+   public:
+    FrameScheduler(Clock &clock, std::function<void()> showFrame) : clock_(clock), showFrame_(showFrame){};
+    // Restarts the schedule at the current time, e.g. after the pattern has been changed
+    void resync();
+    // Waits for the current deadline, shows the frame and keeps it for durationUs
+    void present(uint32_t durationUs);
+    // Shows the frame right away without a deadline, for patterns that run as fast as possible
+    void presentImmediately();
+    // Keeps the current frame for another durationUs without showing anything
+    void hold(uint32_t durationUs);
+    // Waits until the next frame has to be shown to meet the current deadline, but at most about maxWaitUs.
+    // Long waits yield to other tasks, only the last tick before the deadline is spent busy waiting.
+    void waitForDeadline(uint32_t maxWaitUs = UINT32_MAX);
+    // Whether the next frame has to be shown now to meet the current deadline
+    bool isDeadlineReached() const;
+    // Asks the pattern to return from perform() early, e.g. because another pattern has been selected.
+    // May be called from any thread, cleared by resync().
+    void requestInterrupt() { isInterruptRequested_ = true; }
+    bool isInterruptRequested() const { return isInterruptRequested_; }
+    Clock &getClock() const { return clock_; }
+    // Called for every frame before waiting for its deadline, e.g. to convert the frame to the led buffer
+    void setOutputPass(std::function<void()> outputPass) { outputPass_ = outputPass; }
+
+    // Human readable jitter and deadline miss statistics. May be called from any thread.
+    std::string getStatistics() const;
+    void resetStatistics();
+    uint32_t getFrameCount() const { return frameCount_; }
+    uint32_t getMissCount() const { return missCount_; }
+    // Time at which the first frame was latched, or -1 if no frame has been shown yet. Not affected by resets.
+    int64_t getFirstFrameTimeUs() const { return firstFrameTimeUs_; }
+
+   private:
+    // Frames latched later than this after their deadline count as missed
+    static const uint32_t MISS_TOLERANCE_US_ = 1000;
+    // If a frame is late by more than this, the schedule is restarted instead of catching up with short frames
+    static const uint32_t MAX_LATENESS_US_ = 50000;
+    static const unsigned LATENESS_BUCKET_COUNT_ = 9;
+
+    Clock &clock_;
+    std::function<void()> showFrame_;
+    std::function<void()> outputPass_;
+    int64_t deadlineUs_{0};
+    std::atomic_bool isInterruptRequested_{false};
+    // Exponential moving average of the duration of showFrame_()
+    int64_t showDurationUs_{0};
+
+    std::array<std::atomic<uint32_t>, LATENESS_BUCKET_COUNT_> latenessHistogram_{};
+    std::atomic<uint32_t> frameCount_{0};
+    std::atomic<uint32_t> missCount_{0};
+    std::atomic<uint32_t> resyncCount_{0};
+    std::atomic<uint32_t> maxLatenessUs_{0};
+    std::atomic<uint32_t> lastShowDurationUs_{0};
+    std::atomic<int64_t> firstFrameTimeUs_{-1};
+
+    int64_t now() const { return clock_.nowUs(); }
+    // show() has to be started at this time for the frame to be latched at the current deadline
+    int64_t showStartUs() const { return deadlineUs_ - showDurationUs_; }
+    void show();
+    void recordLateness(int64_t latenessUs);
+};
+};  // namespace Timing
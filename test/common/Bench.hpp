@@ -0,0 +1,80 @@
+#pragma once
+
+#include "patterns/AbstractPattern.hpp"
+#include "render/ColumnWorkerPool.hpp"
+#include "render/Rgb16.hpp"
+#include "timing/Clock.hpp"
+#include "timing/FrameScheduler.hpp"
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <vector>
+
+// Rig and timing helpers shared by the host tests. Timings are host timings: they compare implementations with each
+// other and don't stand in for measurements on the ESP32.
+namespace Bench {
+// The rig of the tests: 10 lights of 144 pixels
+const unsigned ROW_COUNT = 144;
+const unsigned COLUMN_COUNT = 10;
+const uint32_t SEED = 1234;
+
+// Average duration of frame() in microseconds
+inline double measureUs(unsigned frameCount, const std::function<void()> &frame) {
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < frameCount; i++) {
+        frame();
+    }
+    std::chrono::duration<double, std::micro> duration = std::chrono::steady_clock::now() - start;
+    return duration.count() / frameCount;
+}
+
+// Runs a pattern like the show loop does, but through a FrameScheduler with a Timing::VirtualClock, so that frames
+// are shown right away and only rendering takes time. Counts the shown frames.
+struct PatternRunner {
+    const unsigned rowCount;
+    const unsigned columnCount;
+    Timing::VirtualClock clock;
+    unsigned frameCount{0};
+    // Called for every shown frame
+    std::function<void()> onFrame;
+    Timing::FrameScheduler frameScheduler{clock, [this] {
+                                              frameCount++;
+                                              if (onFrame) {
+                                                  onFrame();
+                                              }
+                                          }};
+    std::vector<CRGB> leds;
+    std::vector<Render::Rgb16> highDepthLeds;
+
+    explicit PatternRunner(unsigned rowCount = ROW_COUNT, unsigned columnCount = COLUMN_COUNT)
+        : rowCount(rowCount), columnCount(columnCount), leds(rowCount * columnCount), highDepthLeds(leds.size()) {}
+
+    void init(Pattern::AbstractPattern &pattern, Render::ColumnWorkerPool *workerPool = nullptr) {
+        pattern.setRandomSeed(SEED);
+        pattern.init(rowCount, columnCount);
+        pattern.setFrameScheduler(&frameScheduler);
+        pattern.setHighDepthBuffer(&highDepthLeds);
+        pattern.setWorkerPool(workerPool);
+        frameScheduler.resync();
+    }
+    // Returns the off duration in milliseconds
+    unsigned perform(Pattern::AbstractPattern &pattern) {
+        std::fill(leds.begin(), leds.end(), CRGB(0));
+        std::fill(highDepthLeds.begin(), highDepthLeds.end(), Render::Rgb16());
+        unsigned offDurationMs = pattern.perform(leds, CRGB::Purple);
+        frameScheduler.hold(offDurationMs * 1000);
+        frameScheduler.waitForDeadline();
+        return offDurationMs;
+    }
+};
+
+// Average host time per shown frame of the pattern over performCount performs
+inline double measureFrameUs(Pattern::AbstractPattern &pattern, unsigned performCount,
+                             Render::ColumnWorkerPool *workerPool = nullptr, unsigned rowCount = ROW_COUNT,
+                             unsigned columnCount = COLUMN_COUNT) {
+    PatternRunner runner(rowCount, columnCount);
+    runner.init(pattern, workerPool);
+    const double performUs = measureUs(performCount, [&] { runner.perform(pattern); });
+    return performUs * performCount / runner.frameCount;
+}
+};  // namespace Bench
@@ -0,0 +1,58 @@
+#pragma once
+
+// Host replacement for the parts of the Arduino core that the portable sources use (see [env:native] in
+// platformio.ini). Only included by host builds.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <numeric>
+#include <random>
+#include <string>
+#include <thread>
+
+using std::max;
+using std::min;
+
+#define constrain(amount, low, high) ((amount) < (low) ? (low) : ((amount) > (high) ? (high) : (amount)))
+
+inline std::mt19937 &hostRandomGenerator() {
+    static std::mt19937 generator(0);
+    return generator;
+}
+
+inline uint32_t esp_random() { return hostRandomGenerator()(); }
+inline void randomSeed(unsigned long seed) { hostRandomGenerator().seed(seed); }
+inline long random(long max) { return max > 0 ? esp_random() % max : 0; }
+inline long random(long min, long max) { return min < max ? min + random(max - min) : min; }
+
+inline int64_t esp_timer_get_time() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+inline unsigned long millis() { return esp_timer_get_time() / 1000; }
+inline unsigned long micros() { return esp_timer_get_time(); }
+inline void delay(unsigned long durationMs) { std::this_thread::sleep_for(std::chrono::milliseconds(durationMs)); }
+
+class HardwareSerial {
+   public:
+    void begin(unsigned long) {}
+    template <typename T> void print(const T &value) { std::fputs(std::to_string(value).c_str(), stdout); }
+    void print(const char *text) { std::fputs(text, stdout); }
+    template <typename T> void println(const T &value) { std::puts(std::to_string(value).c_str()); }
+    void println(const char *text) { std::puts(text); }
+    void println() { std::puts(""); }
+    void printf(const char *format, ...) __attribute__((format(printf, 2, 3))) {
+        va_list arguments;
+        va_start(arguments, format);
+        std::vprintf(format, arguments);
+        va_end(arguments);
+    }
+};
+static HardwareSerial Serial __attribute__((unused));
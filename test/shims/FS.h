@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdio>
+#include <memory>
+#include <string>
+
+// Host files under a root directory, with the subset of the Arduino file API that the portable sources use
+namespace fs {
+class File {
+   public:
+    File(){};
+    explicit File(std::FILE *file) {
+        if (file) {
+            file_.reset(file, &std::fclose);
+        }
+    }
+    size_t read(uint8_t *buffer, size_t size) { return file_ ? std::fread(buffer, 1, size, file_.get()) : 0; }
+    size_t write(const uint8_t *buffer, size_t size) { return file_ ? std::fwrite(buffer, 1, size, file_.get()) : 0; }
+    bool seek(uint32_t position) { return file_ && std::fseek(file_.get(), position, SEEK_SET) == 0; }
+    size_t position() const { return file_ ? std::ftell(file_.get()) : 0; }
+    size_t size() const {
+        if (!file_) {
+            return 0;
+        }
+        const long position = std::ftell(file_.get());
+        std::fseek(file_.get(), 0, SEEK_END);
+        const long size = std::ftell(file_.get());
+        std::fseek(file_.get(), position, SEEK_SET);
+        return size;
+    }
+    void close() { file_.reset(); }
+    explicit operator bool() const { return (bool)file_; }
+
+   private:
+    std::shared_ptr<std::FILE> file_;
+};
+
+class FS {
+   public:
+    explicit FS(const std::string &root = ".") : root_(root){};
+    File open(const char *path, const char *mode = "r") {
+        const std::string binaryMode = std::string(mode) + "b";
+        return File(std::fopen((root_ + path).c_str(), binaryMode.c_str()));
+    }
+    bool exists(const char *path) { return (bool)open(path); }
+    bool remove(const char *path) { return std::remove((root_ + path).c_str()) == 0; }
+    bool rename(const char *from, const char *to) {
+        return std::rename((root_ + from).c_str(), (root_ + to).c_str()) == 0;
+    }
+
+   private:
+    std::string root_;
+};
+};  // namespace fs
+
+using fs::File;
@@ -0,0 +1,154 @@
+#pragma once
+
+// Host replacement for the parts of FastLED that the portable sources use (see [env:native] in platformio.ini).
+// Scaling and blending follow FastLED's formulas, hsv2rgb_rainbow() is approximated by a plain HSV conversion.
+// Nothing is sent out: show() and clear() only exist so that patterns compile.
+
+#include "Arduino.h"
+
+typedef uint8_t fract8;
+
+enum EOrder { RGB = 0012, GRB = 0102 };
+#define BINARY_DITHER 0x01
+#define DISABLE_DITHER 0x00
+
+inline uint8_t scale8(uint8_t value, fract8 scale) { return ((uint16_t)value * (1 + scale)) >> 8; }
+inline uint8_t scale8_video(uint8_t value, fract8 scale) {
+    return (((int)value * (int)scale) >> 8) + ((value && scale) ? 1 : 0);
+}
+inline uint8_t qadd8(uint8_t a, uint8_t b) { return min(a + b, 255); }
+inline uint8_t blend8(uint8_t a, uint8_t b, uint8_t amountOfB) {
+    uint16_t partial = (a << 8) | b;
+    partial += b * amountOfB;
+    partial -= a * amountOfB;
+    return partial >> 8;
+}
+
+struct CRGB {
+    union {
+        struct {
+            union {
+                uint8_t r;
+                uint8_t red;
+            };
+            union {
+                uint8_t g;
+                uint8_t green;
+            };
+            union {
+                uint8_t b;
+                uint8_t blue;
+            };
+        };
+        uint8_t raw[3];
+    };
+
+    enum HTMLColorCode {
+        Black = 0x000000,
+        Blue = 0x0000FF,
+        Green = 0x008000,
+        Purple = 0x800080,
+        Red = 0xFF0000,
+        White = 0xFFFFFF,
+    };
+
+    // As in FastLED, only value initialization zeroes a color, e.g. in std::vector<CRGB>(n)
+    CRGB() = default;
+    CRGB(uint8_t red, uint8_t green, uint8_t blue) : r(red), g(green), b(blue) {}
+    CRGB(uint32_t colorCode) : r(colorCode >> 16), g(colorCode >> 8), b(colorCode) {}
+    CRGB(HTMLColorCode colorCode) : CRGB((uint32_t)colorCode) {}
+
+    uint8_t &operator[](uint8_t index) { return raw[index]; }
+    const uint8_t &operator[](uint8_t index) const { return raw[index]; }
+    // Not explicit, as in FastLED 3.5
+    operator bool() const { return r || g || b; }
+
+    CRGB &nscale8(uint8_t scale) {
+        r = scale8(r, scale);
+        g = scale8(g, scale);
+        b = scale8(b, scale);
+        return *this;
+    }
+    CRGB &nscale8_video(uint8_t scale) {
+        r = scale8_video(r, scale);
+        g = scale8_video(g, scale);
+        b = scale8_video(b, scale);
+        return *this;
+    }
+    CRGB &fadeToBlackBy(uint8_t fadeFactor) { return nscale8(255 - fadeFactor); }
+    CRGB &operator+=(const CRGB &other) {
+        r = qadd8(r, other.r);
+        g = qadd8(g, other.g);
+        b = qadd8(b, other.b);
+        return *this;
+    }
+    CRGB &operator|=(const CRGB &other) {
+        r = max(r, other.r);
+        g = max(g, other.g);
+        b = max(b, other.b);
+        return *this;
+    }
+};
+
+inline bool operator==(const CRGB &a, const CRGB &b) { return a.r == b.r && a.g == b.g && a.b == b.b; }
+inline bool operator!=(const CRGB &a, const CRGB &b) { return !(a == b); }
+
+struct CHSV {
+    uint8_t h;
+    uint8_t s;
+    uint8_t v;
+    CHSV() : h(0), s(0), v(0) {}
+    CHSV(uint8_t hue, uint8_t saturation, uint8_t value) : h(hue), s(saturation), v(value) {}
+};
+
+inline void hsv2rgb_rainbow(const CHSV &hsv, CRGB &rgb) {
+    const uint8_t region = hsv.h / 43;
+    const uint8_t remainder = (hsv.h - region * 43) * 6;
+    const uint8_t p = (hsv.v * (255 - hsv.s)) >> 8;
+    const uint8_t q = (hsv.v * (255 - ((hsv.s * remainder) >> 8))) >> 8;
+    const uint8_t t = (hsv.v * (255 - ((hsv.s * (255 - remainder)) >> 8))) >> 8;
+    switch (region) {
+    case 0:
+        rgb = CRGB(hsv.v, t, p);
+        break;
+    case 1:
+        rgb = CRGB(q, hsv.v, p);
+        break;
+    case 2:
+        rgb = CRGB(p, hsv.v, t);
+        break;
+    case 3:
+        rgb = CRGB(p, q, hsv.v);
+        break;
+    case 4:
+        rgb = CRGB(t, p, hsv.v);
+        break;
+    default:
+        rgb = CRGB(hsv.v, p, q);
+        break;
+    }
+}
+
+inline CRGB blend(const CRGB &a, const CRGB &b, fract8 amountOfB) {
+    return CRGB(blend8(a.r, b.r, amountOfB), blend8(a.g, b.g, amountOfB), blend8(a.b, b.b, amountOfB));
+}
+
+inline void fadeToBlackBy(CRGB *leds, uint16_t count, uint8_t fadeBy) {
+    for (uint16_t i = 0; i < count; i++) {
+        leds[i].fadeToBlackBy(fadeBy);
+    }
+}
+
+class CFastLED {
+   public:
+    void show() {}
+    void clear(bool = false) {}
+    void clearData() {}
+    void setBrightness(uint8_t brightness) { brightness_ = brightness; }
+    uint8_t getBrightness() const { return brightness_; }
+    void setDither(uint8_t) {}
+
+   private:
+    uint8_t brightness_{255};
+};
+static CFastLED FastLED;
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Only needed for the declaration of Audio::UdpAudioSource, which is not part of host builds
+class WiFiUDP {
+   public:
+    uint8_t begin(uint16_t) { return 0; }
+    int parsePacket() { return 0; }
+    int read(uint8_t *, size_t) { return 0; }
+};
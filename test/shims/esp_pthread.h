@@ -0,0 +1,27 @@
+#pragma once
+
+// Host threads can't be pinned, so the pthread config is only stored
+#define ESP_OK 0
+#define ESP_ERROR_CHECK(x) (void)(x)
+
+struct esp_pthread_cfg_t {
+    size_t stack_size;
+    size_t prio;
+    bool inherit_cfg;
+    const char *thread_name;
+    int pin_to_core;
+};
+
+inline esp_pthread_cfg_t &hostPthreadConfig() {
+    static esp_pthread_cfg_t config{4096, 5, false, nullptr, -1};
+    return config;
+}
+inline esp_pthread_cfg_t esp_pthread_get_default_config() { return {4096, 5, false, nullptr, -1}; }
+inline int esp_pthread_set_cfg(const esp_pthread_cfg_t *config) {
+    hostPthreadConfig() = *config;
+    return ESP_OK;
+}
+inline int esp_pthread_get_cfg(esp_pthread_cfg_t *config) {
+    *config = hostPthreadConfig();
+    return ESP_OK;
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+#include <chrono>
+#include <thread>
+
+// Tasks run as detached threads, priorities and cores are ignored
+inline BaseType_t xTaskCreatePinnedToCore(TaskFunction_t task, const char *, uint32_t, void *parameter, UBaseType_t,
+                                          TaskHandle_t *, BaseType_t) {
+    std::thread(task, parameter).detach();
+    return pdPASS;
+}
+inline void vTaskDelay(TickType_t ticks) { std::this_thread::sleep_for(std::chrono::milliseconds(ticks)); }
@@ -0,0 +1,224 @@
+// Tests of the FixedPointFft, the FileAudioSource and the onset detection of the AudioAnalyzer, and host benchmarks
+// of the FFT throughput and the onset latency. Test signals are written as WAV files to a temporary directory and
+// played through a FileAudioSource that doesn't wait for real time.
+#include "audio/AudioAnalyzer.hpp"
+#include "audio/FileAudioSource.hpp"
+#include "audio/FixedPointFft.hpp"
+#include "common/Bench.hpp"
+#include <cmath>
+#include <memory>
+#include <unity.h>
+#include <vector>
+
+const char *WAV_PATH = "/ravelights_test_audio.wav";
+const unsigned SAMPLE_RATE = 22050;
+const unsigned FFT_SIZE = Audio::FixedPointFft::SIZE;
+
+fs::FS tempFs(P_tmpdir);
+
+void appendUint16(std::string &bytes, uint16_t value) {
+    bytes += (char)(value & 0xff);
+    bytes += (char)(value >> 8);
+}
+
+void appendUint32(std::string &bytes, uint32_t value) {
+    appendUint16(bytes, value & 0xffff);
+    appendUint16(bytes, value >> 16);
+}
+
+// Writes a WAV file with an extra chunk before the samples, which readers have to skip
+bool writeWav(const std::vector<int16_t> &samples, unsigned sampleRate = SAMPLE_RATE, uint16_t channelCount = 1) {
+    std::string bytes = "RIFF";
+    appendUint32(bytes, 4 + 8 + 16 + 8 + 3 + 1 + 8 + 2 * samples.size());
+    bytes += "WAVEfmt ";
+    appendUint32(bytes, 16);
+    appendUint16(bytes, 1);
+    appendUint16(bytes, channelCount);
+    appendUint32(bytes, sampleRate);
+    appendUint32(bytes, sampleRate * 2 * channelCount);
+    appendUint16(bytes, 2 * channelCount);
+    appendUint16(bytes, 16);
+    bytes += "LIST";
+    appendUint32(bytes, 3);
+    bytes += std::string("abc\0", 4);
+    bytes += "data";
+    appendUint32(bytes, 2 * samples.size());
+    for (int16_t sample : samples) {
+        appendUint16(bytes, sample);
+    }
+    fs::File file = tempFs.open(WAV_PATH, "w");
+    return file && file.write(reinterpret_cast<const uint8_t *>(bytes.data()), bytes.size()) == bytes.size();
+}
+
+// Bass drum hits: decaying 60 Hz sine bursts over quiet noise, like a four to the floor beat
+std::vector<int16_t> makeClickTrack(const std::vector<unsigned> &clickStarts, unsigned sampleCount) {
+    std::vector<int16_t> samples(sampleCount);
+    uint32_t noise = 1;
+    for (unsigned i = 0; i < sampleCount; i++) {
+        noise = noise * 1664525 + 1013904223;
+        samples[i] = (int32_t)(noise >> 16) % 200 - 100;
+    }
+    for (unsigned clickStart : clickStarts) {
+        for (unsigned i = 0; i < SAMPLE_RATE / 5 && clickStart + i < sampleCount; i++) {
+            const double time = (double)i / SAMPLE_RATE;
+            samples[clickStart + i] += 20000 * std::exp(-time / 0.05) * std::sin(2 * M_PI * 60 * time);
+        }
+    }
+    return samples;
+}
+
+// Start sample of each click of a track at 120 beats per minute, after a second of silence
+std::vector<unsigned> clickStartsAt120Bpm(unsigned clickCount) {
+    std::vector<unsigned> clickStarts;
+    for (unsigned i = 0; i < clickCount; i++) {
+        clickStarts.push_back(SAMPLE_RATE + i * SAMPLE_RATE / 2);
+    }
+    return clickStarts;
+}
+
+// Index of the hop in which each onset has been detected, from the start of the file
+std::vector<unsigned> detectOnsets(unsigned sampleCount) {
+    auto source = std::make_shared<Audio::FileAudioSource>(tempFs, WAV_PATH, false);
+    Audio::AudioAnalyzer analyzer(source);
+    source->begin();
+    std::vector<int16_t> hop(Audio::AudioAnalyzer::HOP_SIZE);
+    std::vector<unsigned> onsetHops;
+    uint32_t onsetCount = 0;
+    for (unsigned hopIndex = 0; hopIndex < sampleCount / hop.size(); hopIndex++) {
+        source->read(hop.data(), hop.size());
+        analyzer.processHop(hop.data());
+        if (analyzer.getFeatures().onsetCount != onsetCount) {
+            onsetCount = analyzer.getFeatures().onsetCount;
+            onsetHops.push_back(hopIndex);
+        }
+    }
+    return onsetHops;
+}
+
+void setUp() {}
+void tearDown() { tempFs.remove(WAV_PATH); }
+
+void test_fft_puts_a_sine_into_its_bin() {
+    Audio::FixedPointFft fft;
+    for (unsigned bin : {3, 37, 100, 255}) {
+        std::array<int16_t, FFT_SIZE> real, imaginary;
+        for (unsigned i = 0; i < FFT_SIZE; i++) {
+            real[i] = std::lround(16000 * std::sin(2 * M_PI * bin * i / FFT_SIZE));
+            imaginary[i] = 0;
+        }
+        fft.transform(real, imaginary);
+        // The result is scaled by 1 / SIZE, so a sine of amplitude A shows up with magnitude A / 2 in its bin
+        unsigned peakBin = 0;
+        double peakMagnitude = 0;
+        double otherMagnitudes = 0;
+        for (unsigned i = 0; i <= FFT_SIZE / 2; i++) {
+            const double magnitude = std::hypot(real[i], imaginary[i]);
+            if (magnitude > peakMagnitude) {
+                otherMagnitudes += peakMagnitude;
+                peakBin = i;
+                peakMagnitude = magnitude;
+            } else {
+                otherMagnitudes += magnitude;
+            }
+        }
+        TEST_ASSERT_EQUAL_UINT(bin, peakBin);
+        TEST_ASSERT_FLOAT_WITHIN(80, 8000, peakMagnitude);
+        TEST_ASSERT_TRUE(otherMagnitudes < 0.05 * peakMagnitude);
+    }
+}
+
+void test_wav_files_are_read_and_looped() {
+    std::vector<int16_t> samples;
+    for (int i = 0; i < 1000; i++) {
+        samples.push_back(i * 60 - 30000);
+    }
+    TEST_ASSERT_TRUE(writeWav(samples, 44100));
+    Audio::FileAudioSource source(tempFs, WAV_PATH, false);
+    TEST_ASSERT_TRUE(source.isValid());
+    TEST_ASSERT_EQUAL_UINT(44100, source.getSampleRate());
+    source.begin();
+    std::vector<int16_t> readSamples(2500);
+    // In reads of odd sizes, so that the loop is reached in the middle of a read
+    for (unsigned offset = 0; offset < readSamples.size(); offset += 500) {
+        source.read(&readSamples[offset], 333);
+        source.read(&readSamples[offset + 333], 167);
+    }
+    for (unsigned i = 0; i < readSamples.size(); i++) {
+        TEST_ASSERT_EQUAL_INT(samples[i % samples.size()], readSamples[i]);
+    }
+}
+
+void test_other_formats_play_silence() {
+    TEST_ASSERT_TRUE(writeWav(std::vector<int16_t>(100, 1000), SAMPLE_RATE, 2));
+    Audio::FileAudioSource stereoSource(tempFs, WAV_PATH, false);
+    TEST_ASSERT_FALSE(stereoSource.isValid());
+    Audio::FileAudioSource missingSource(tempFs, "/ravelights_missing.wav", false);
+    TEST_ASSERT_FALSE(missingSource.isValid());
+    std::vector<int16_t> samples(100, 1);
+    missingSource.read(samples.data(), samples.size());
+    TEST_ASSERT_TRUE(samples == std::vector<int16_t>(100, 0));
+}
+
+void test_every_click_is_detected_once() {
+    const unsigned clickCount = 20;
+    const unsigned sampleCount = SAMPLE_RATE * 12;
+    const std::vector<unsigned> clickStarts = clickStartsAt120Bpm(clickCount);
+    TEST_ASSERT_TRUE(writeWav(makeClickTrack(clickStarts, sampleCount)));
+    const std::vector<unsigned> onsetHops = detectOnsets(sampleCount);
+    TEST_ASSERT_EQUAL_UINT(clickCount, onsetHops.size());
+    for (unsigned i = 0; i < clickCount; i++) {
+        // Detected in the hop that contains the start of the click, or soon after
+        const unsigned clickHop = clickStarts[i] / Audio::AudioAnalyzer::HOP_SIZE;
+        TEST_ASSERT_TRUE(onsetHops[i] >= clickHop && onsetHops[i] <= clickHop + 2);
+    }
+}
+
+void test_benchmark_fft_and_onset_latency() {
+    Audio::FixedPointFft fft;
+    std::array<int16_t, FFT_SIZE> real, imaginary;
+    uint32_t noise = 1;
+    const double fftUs = Bench::measureUs(20000, [&] {
+        for (unsigned i = 0; i < FFT_SIZE; i++) {
+            noise = noise * 1664525 + 1013904223;
+            real[i] = noise >> 16;
+            imaginary[i] = 0;
+        }
+        fft.transform(real, imaginary);
+    });
+
+    const unsigned clickCount = 100;
+    const unsigned sampleCount = SAMPLE_RATE * 52;
+    const std::vector<unsigned> clickStarts = clickStartsAt120Bpm(clickCount);
+    TEST_ASSERT_TRUE(writeWav(makeClickTrack(clickStarts, sampleCount)));
+    std::vector<unsigned> onsetHops;
+    const double analysisUs = Bench::measureUs(1, [&] { onsetHops = detectOnsets(sampleCount); });
+    TEST_ASSERT_EQUAL_UINT(clickCount, onsetHops.size());
+    // From the start of a click to the end of the hop in which it has been detected, i.e. the earliest time the
+    // analyzer could have published it
+    double totalLatencyMs = 0;
+    double maxLatencyMs = 0;
+    for (unsigned i = 0; i < clickCount; i++) {
+        const unsigned detectedSample = (onsetHops[i] + 1) * Audio::AudioAnalyzer::HOP_SIZE;
+        const double latencyMs = 1000.0 * (detectedSample - clickStarts[i]) / SAMPLE_RATE;
+        totalLatencyMs += latencyMs;
+        maxLatencyMs = std::max(maxLatencyMs, latencyMs);
+    }
+    const unsigned hopCount = sampleCount / Audio::AudioAnalyzer::HOP_SIZE;
+    char message[160];
+    snprintf(message, sizeof(message), "%u point FFT: %.2f us, analysis: %.2f us per hop of %.1f ms audio", FFT_SIZE,
+             fftUs, analysisUs / hopCount, 1000.0 * Audio::AudioAnalyzer::HOP_SIZE / SAMPLE_RATE);
+    TEST_MESSAGE(message);
+    snprintf(message, sizeof(message), "Onset latency over %u clicks: %.1f ms on average, %.1f ms at most", clickCount,
+             totalLatencyMs / clickCount, maxLatencyMs);
+    TEST_MESSAGE(message);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_fft_puts_a_sine_into_its_bin);
+    RUN_TEST(test_wav_files_are_read_and_looped);
+    RUN_TEST(test_other_formats_play_silence);
+    RUN_TEST(test_every_click_is_detected_once);
+    RUN_TEST(test_benchmark_fft_and_onset_latency);
+    return UNITY_END();
+}
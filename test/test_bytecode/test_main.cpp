@@ -0,0 +1,192 @@
+// Tests of the pattern language interpreter and a host benchmark of the ports in programs/ against the native
+// patterns. Frames are shown through a FrameScheduler with a Timing::VirtualClock, so only rendering is measured.
+#include "common/Bench.hpp"
+#include "patterns/BytecodePattern.hpp"
+#include "patterns/Twinkle.hpp"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <unity.h>
+#include <vector>
+
+using Bench::PatternRunner;
+using Bench::measureFrameUs;
+
+// Reads a program from programs/, which is found relative to this file. Returns "" if it can't be read.
+std::string readProgram(const std::string &name) {
+    std::string path = __FILE__;
+    path = path.substr(0, path.rfind("test/test_bytecode")) + "programs/" + name;
+    std::ifstream file(path);
+    std::stringstream source;
+    source << file.rdbuf();
+    return source.str();
+}
+
+// C++ version of programs/comet.asm: a single comet at 8 bits, faded like FADECOL, with random numbers drawn in the
+// same order. The Comet pattern draws 2 or 3 comets into the 16 bit buffer and fades random pixels, so its timings
+// aren't comparable with the program.
+class SingleComet : public Pattern::AbstractPattern {
+   public:
+    unsigned perform(std::vector<CRGB> &leds, CRGB color) override {
+        const int rowCount = rowCount_;
+        const int cometSize = rowCount / 8;
+        const int speed = columnCount_ + 1;
+        const unsigned columnIndex = random(columnCount_);
+        CRGB *pixels = &leds[getStartIndexOfColumn(columnIndex)];
+        for (int position = 0; position < rowCount; position += speed) {
+            fadeToBlackBy(pixels, rowCount, 100);
+            std::fill(pixels + position, pixels + std::min(position + cometSize, rowCount), color);
+            showForEffectiveDuration(30);
+        }
+        do {
+            fadeToBlackBy(pixels, rowCount, 100);
+            showForEffectiveDuration(30);
+        } while (!isColumnCompletelyDark(leds, columnIndex));
+        return random(1000) + 10;
+    }
+};
+
+// FNV-1a hash of every shown frame
+std::vector<uint64_t> hashFrames(Pattern::AbstractPattern &pattern, unsigned performCount) {
+    PatternRunner runner;
+    std::vector<uint64_t> hashes;
+    runner.onFrame = [&] {
+        uint64_t hash = 14695981039346656037ULL;
+        for (const CRGB &pixel : runner.leds) {
+            for (uint8_t channel : pixel.raw) {
+                hash = (hash ^ channel) * 1099511628211ULL;
+            }
+        }
+        hashes.push_back(hash);
+    };
+    runner.init(pattern);
+    for (unsigned i = 0; i < performCount; i++) {
+        runner.perform(pattern);
+    }
+    return hashes;
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_arithmetic_wraps_around() {
+    Pattern::BytecodePattern pattern(R"(
+        set r0 0x7fffffff
+        addi r0 r0 1
+        set r1 -2147483648
+        sub r2 r0 r1            # 0 if the addition wrapped around
+        jnz r2 fail
+        mul r2 r1 r1            # 2^62 wraps around to 0
+        jnz r2 fail
+        set r3 -1
+        div r4 r1 r3            # -INT32_MIN wraps around to INT32_MIN
+        sub r2 r4 r1
+        jnz r2 fail
+        mod r4 r1 r3
+        jnz r4 fail
+        set r5 1
+        end r5
+fail:   stop
+    )");
+    PatternRunner runner;
+    runner.init(pattern);
+    TEST_ASSERT_EQUAL_UINT(1, runner.perform(pattern));
+}
+
+// Durations are capped at 60 s instead of overflowing when they are converted to microseconds
+void test_frame_durations_are_capped() {
+    Pattern::BytecodePattern pattern(R"(
+        set r0 0x7fffffff
+        show r0
+        stop
+    )");
+    PatternRunner runner;
+    runner.init(pattern);
+    runner.perform(pattern);
+    TEST_ASSERT_EQUAL_INT64(60000000, runner.clock.nowUs());
+}
+
+void test_off_durations_are_capped() {
+    Pattern::BytecodePattern pattern(R"(
+        set r0 0x7fffffff
+        end r0
+    )");
+    PatternRunner runner;
+    runner.init(pattern);
+    TEST_ASSERT_EQUAL_UINT(60000, runner.perform(pattern));
+}
+
+void test_endless_loops_return_after_five_seconds_of_frames() {
+    Pattern::BytecodePattern pattern(R"(
+        set r0 1000
+loop:   show r0
+        jmp loop
+    )");
+    PatternRunner runner;
+    runner.init(pattern);
+    TEST_ASSERT_EQUAL_UINT(0, runner.perform(pattern));
+    TEST_ASSERT_EQUAL_UINT(5, runner.frameCount);
+    TEST_ASSERT_EQUAL_INT64(5000000, runner.clock.nowUs());
+}
+
+void test_interrupts_end_perform_after_the_current_frame() {
+    Pattern::BytecodePattern pattern(R"(
+        set r0 10
+loop:   show r0
+        jmp loop
+    )");
+    PatternRunner runner;
+    runner.init(pattern);
+    runner.onFrame = [&runner] {
+        if (runner.frameCount == 3) {
+            runner.frameScheduler.requestInterrupt();
+        }
+    };
+    runner.perform(pattern);
+    TEST_ASSERT_EQUAL_UINT(3, runner.frameCount);
+}
+
+// The benchmark below is only fair if both do the same work
+void test_comet_program_matches_its_cpp_version() {
+    const std::string cometSource = readProgram("comet.asm");
+    TEST_ASSERT_FALSE(cometSource.empty());
+    SingleComet comet;
+    Pattern::BytecodePattern cometProgram(cometSource);
+    const std::vector<uint64_t> frameHashes = hashFrames(comet, 20);
+    TEST_ASSERT_TRUE(frameHashes.size() > 20);
+    TEST_ASSERT_TRUE(frameHashes == hashFrames(cometProgram, 20));
+}
+
+void test_benchmark_programs_against_native_patterns() {
+    const std::string twinkleSource = readProgram("twinkle.asm");
+    const std::string cometSource = readProgram("comet.asm");
+    TEST_ASSERT_FALSE(twinkleSource.empty());
+    TEST_ASSERT_FALSE(cometSource.empty());
+    Pattern::Twinkle twinkle;
+    Pattern::BytecodePattern twinkleProgram(twinkleSource);
+    SingleComet comet;
+    Pattern::BytecodePattern cometProgram(cometSource);
+    const double twinkleUs = measureFrameUs(twinkle, 20000);
+    const double twinkleProgramUs = measureFrameUs(twinkleProgram, 20000);
+    const double cometUs = measureFrameUs(comet, 2000);
+    const double cometProgramUs = measureFrameUs(cometProgram, 2000);
+    char message[160];
+    snprintf(message, sizeof(message), "Twinkle: %.2f us per frame native, %.2f us as program (%.1fx)", twinkleUs,
+             twinkleProgramUs, twinkleProgramUs / twinkleUs);
+    TEST_MESSAGE(message);
+    snprintf(message, sizeof(message), "Single comet: %.2f us per frame in C++, %.2f us as program (%.1fx)", cometUs,
+             cometProgramUs, cometProgramUs / cometUs);
+    TEST_MESSAGE(message);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_arithmetic_wraps_around);
+    RUN_TEST(test_frame_durations_are_capped);
+    RUN_TEST(test_off_durations_are_capped);
+    RUN_TEST(test_endless_loops_return_after_five_seconds_of_frames);
+    RUN_TEST(test_interrupts_end_perform_after_the_current_frame);
+    RUN_TEST(test_comet_program_matches_its_cpp_version);
+    RUN_TEST(test_benchmark_programs_against_native_patterns);
+    return UNITY_END();
+}
@@ -0,0 +1,97 @@
+// Tests and host benchmarks of the palette lookup tables. The benchmarks compare palette-indexed rendering with the
+// single color fill it replaces and report through TEST_MESSAGE; their timings are host timings, not ESP32 ones.
+#include "common/Bench.hpp"
+#include "palette/Palette.hpp"
+#include "patterns/AbstractPattern.hpp"
+#include <unity.h>
+#include <vector>
+
+// Exposes the column fills that patterns use
+class ColumnFill : public Pattern::AbstractPattern {
+   public:
+    unsigned perform(std::vector<CRGB> &, CRGB) override { return 0; }
+    void fillWithColor(std::vector<CRGB> &leds, CRGB color) {
+        for (unsigned columnIndex = 0; columnIndex < columnCount_; columnIndex++) {
+            lightUpColumn(leds, columnIndex, color, false);
+        }
+    }
+    void fillFromPalette(std::vector<CRGB> &leds, uint8_t paletteStartIndex) {
+        for (unsigned columnIndex = 0; columnIndex < columnCount_; columnIndex++) {
+            lightUpColumnFromPalette(leds, columnIndex, paletteStartIndex, false);
+        }
+    }
+};
+
+using Bench::COLUMN_COUNT;
+using Bench::ROW_COUNT;
+using Bench::measureUs;
+
+void setUp() {}
+void tearDown() {}
+
+void test_gradient_starts_and_ends_at_its_outer_stops() {
+    Palette::Lut lut;
+    TEST_ASSERT_TRUE(Palette::fillFromGradient(lut, "ff0000,00ff00,0000ff"));
+    TEST_ASSERT_TRUE(lut.front() == CRGB(0xff0000));
+    TEST_ASSERT_TRUE(lut.back() == CRGB(0x0000ff));
+}
+
+void test_invalid_gradients_leave_the_palette_untouched() {
+    Palette::Lut lut;
+    lut.fill(CRGB(0x123456));
+    TEST_ASSERT_FALSE(Palette::fillFromGradient(lut, "ff0000"));
+    TEST_ASSERT_FALSE(Palette::fillFromGradient(lut, "ff0000,"));
+    TEST_ASSERT_FALSE(Palette::fillFromGradient(lut, "ff0000,1000000"));
+    TEST_ASSERT_FALSE(Palette::fillFromGradient(lut, "ff0000,00gg00"));
+    TEST_ASSERT_TRUE(lut[128] == CRGB(0x123456));
+}
+
+void test_updates_only_become_active_when_swapped() {
+    Palette::DoubleBufferedPalette palette;
+    TEST_ASSERT_TRUE(palette.getActive() == nullptr);
+    TEST_ASSERT_TRUE(palette.update([](Palette::Lut &lut) { return Palette::fillFromGradient(lut, "ff0000,0000ff"); }));
+    TEST_ASSERT_TRUE(palette.getActive() == nullptr);
+    palette.swapIfPending();
+    TEST_ASSERT_TRUE(palette.getActive() != nullptr);
+    TEST_ASSERT_TRUE((*palette.getActive())[0] == CRGB(0xff0000));
+    TEST_ASSERT_FALSE(palette.update([](Palette::Lut &lut) { return false; }));
+    palette.swapIfPending();
+    TEST_ASSERT_TRUE((*palette.getActive())[0] == CRGB(0xff0000));
+    palette.disable();
+    palette.swapIfPending();
+    TEST_ASSERT_TRUE(palette.getActive() == nullptr);
+}
+
+void test_benchmark_palette_rendering() {
+    ColumnFill pattern;
+    pattern.init(ROW_COUNT, COLUMN_COUNT);
+    Palette::Lut lut;
+    Palette::fillFromHsvSweep(lut, 0, 255);
+    pattern.setPalette(&lut);
+    std::vector<CRGB> leds(ROW_COUNT * COLUMN_COUNT);
+    uint8_t frame = 0;
+    double colorUs = measureUs(20000, [&] { pattern.fillWithColor(leds, CRGB(frame++, 0, 128)); });
+    double paletteUs = measureUs(20000, [&] { pattern.fillFromPalette(leds, frame++); });
+    Palette::DoubleBufferedPalette palette;
+    double swapUs = measureUs(20000, [&] {
+        palette.update([&](Palette::Lut &backLut) {
+            backLut = lut;
+            return true;
+        });
+        palette.swapIfPending();
+    });
+    char message[160];
+    snprintf(message, sizeof(message),
+             "%ux%u pixels: %.2f us per frame with a single color, %.2f us from a palette, %.2f us per palette swap",
+             COLUMN_COUNT, ROW_COUNT, colorUs, paletteUs, swapUs);
+    TEST_MESSAGE(message);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_gradient_starts_and_ends_at_its_outer_stops);
+    RUN_TEST(test_invalid_gradients_leave_the_palette_untouched);
+    RUN_TEST(test_updates_only_become_active_when_swapped);
+    RUN_TEST(test_benchmark_palette_rendering);
+    return UNITY_END();
+}
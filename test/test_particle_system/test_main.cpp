@@ -0,0 +1,133 @@
+// Tests and host benchmarks of the ParticleSystem and the DecayBuffer that Comet, MovingStrobe and Twinkle render with.
+// The benchmarks run on the development machine, so their timings are only comparable with each other, not with the
+// ESP32. They report through TEST_MESSAGE and only fail if the host misses the budget by far.
+#include "common/Bench.hpp"
+#include "patterns/DecayBuffer.hpp"
+#include "patterns/ParticleSystem.hpp"
+#include "render/HashRandom.hpp"
+#include <functional>
+#include <unity.h>
+#include <vector>
+
+const unsigned PARTICLE_COUNT = 500;
+// Budget of a frame at 60 fps
+const double FRAME_BUDGET_US = 1000000.0 / 60;
+
+using Bench::COLUMN_COUNT;
+using Bench::ROW_COUNT;
+using Bench::measureUs;
+
+void setUp() {}
+void tearDown() {}
+
+void test_spawn_fails_when_the_pool_is_full() {
+    Pattern::ParticleSystem particles(2);
+    particles.init(ROW_COUNT, COLUMN_COUNT);
+    TEST_ASSERT_TRUE(particles.spawn(0, 0, 1, 4));
+    TEST_ASSERT_TRUE(particles.spawn(1, 0, 1, 4));
+    TEST_ASSERT_FALSE(particles.spawn(2, 0, 1, 4));
+    TEST_ASSERT_FALSE(particles.spawn(COLUMN_COUNT, 0, 1, 4));
+    TEST_ASSERT_EQUAL_UINT(2, particles.size());
+}
+
+void test_update_removes_particles_that_left_their_column_or_faded_out() {
+    Pattern::ParticleSystem particles(4);
+    particles.init(ROW_COUNT, COLUMN_COUNT);
+    particles.spawn(0, ROW_COUNT - 1, 1, 4);
+    particles.spawn(1, 0, -4, 4);
+    particles.spawn(2, 10, 0, 4, 1, 1);
+    particles.spawn(3, 10, 1, 4);
+    particles.update();
+    TEST_ASSERT_EQUAL_UINT(1, particles.size());
+    TEST_ASSERT_EQUAL_FLOAT(11, particles.getPosition(0));
+}
+
+void test_render_clips_particles_to_their_column() {
+    Pattern::ParticleSystem particles(2);
+    particles.init(ROW_COUNT, COLUMN_COUNT);
+    particles.spawn(1, ROW_COUNT - 2, 0, 4);
+    particles.spawn(2, -2, 0, 4);
+    std::vector<CRGB> leds(ROW_COUNT * COLUMN_COUNT);
+    particles.render(leds, CRGB::White);
+    unsigned litCount = 0;
+    for (unsigned i = 0; i < leds.size(); i++) {
+        if (leds[i]) {
+            litCount++;
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT(4, litCount);
+    TEST_ASSERT_TRUE(leds[2 * ROW_COUNT - 1]);
+    TEST_ASSERT_TRUE(leds[2 * ROW_COUNT + 1]);
+    TEST_ASSERT_FALSE(leds[2 * ROW_COUNT + 2]);
+}
+
+void test_benchmark_500_particles() {
+    Pattern::ParticleSystem particles(PARTICLE_COUNT);
+    particles.init(ROW_COUNT, COLUMN_COUNT);
+    std::vector<CRGB> leds(ROW_COUNT * COLUMN_COUNT);
+    uint32_t counter = 0;
+    auto spawnUntilFull = [&] {
+        while (particles.size() < PARTICLE_COUNT) {
+            uint32_t randomBits = Render::hashRandom(1, counter++);
+            particles.spawn(randomBits % COLUMN_COUNT, (randomBits >> 8) % ROW_COUNT, 0.5f + (randomBits >> 16) % 4,
+                            1 + (randomBits >> 20) % 16, 1, 0.05f);
+        }
+    };
+    double frameUs = measureUs(2000, [&] {
+        spawnUntilFull();
+        std::fill(leds.begin(), leds.end(), CRGB(0));
+        particles.render(leds, CRGB::White);
+        particles.update();
+    });
+    char message[128];
+    snprintf(message, sizeof(message), "%u particles on %ux%u: %.1f us per frame (60 fps budget: %.0f us)",
+             PARTICLE_COUNT, COLUMN_COUNT, ROW_COUNT, frameUs, FRAME_BUDGET_US);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_TRUE_MESSAGE(frameUs < FRAME_BUDGET_US, message);
+}
+
+void test_benchmark_fading_trails() {
+    // Comet's trails: a few lit pixels per column, faded with 50% probability each per frame
+    std::vector<CRGB> leds(ROW_COUNT * COLUMN_COUNT);
+    Pattern::DecayBuffer trails;
+    trails.init(ROW_COUNT, COLUMN_COUNT);
+    uint32_t seed = 0;
+    auto lightUpTrails = [&](const std::function<void(unsigned)> &setPixel) {
+        for (unsigned columnIndex = 0; columnIndex < COLUMN_COUNT; columnIndex += 3) {
+            for (unsigned rowIndex = 0; rowIndex < ROW_COUNT / 8; rowIndex++) {
+                setPixel(columnIndex * ROW_COUNT + (seed + rowIndex) % ROW_COUNT);
+            }
+        }
+        seed++;
+    };
+    // Before the DecayBuffer, every pixel of every column was visited
+    double allPixelsUs = measureUs(5000, [&] {
+        lightUpTrails([&](unsigned pixelIndex) { leds[pixelIndex] = CRGB::White; });
+        for (unsigned i = 0; i < leds.size(); i++) {
+            if (Render::hashRandom(seed, i) & 1) {
+                leds[i].fadeToBlackBy(100);
+            }
+        }
+    });
+    double litPixelsUs = measureUs(5000, [&] {
+        lightUpTrails([&](unsigned pixelIndex) { trails.setPixel(leds, pixelIndex, CRGB(CRGB::White)); });
+        for (unsigned columnIndex = 0; columnIndex < COLUMN_COUNT; columnIndex++) {
+            trails.fadeRandomPixelsToBlackBy(leds, columnIndex, 100, seed);
+        }
+    });
+    char message[128];
+    snprintf(message, sizeof(message), "Fading trails: %.2f us per frame visiting all pixels, %.2f us only lit ones",
+             allPixelsUs, litPixelsUs);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_TRUE_MESSAGE(litPixelsUs < FRAME_BUDGET_US, message);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_spawn_fails_when_the_pool_is_full);
+    RUN_TEST(test_update_removes_particles_that_left_their_column_or_faded_out);
+    RUN_TEST(test_render_clips_particles_to_their_column);
+    RUN_TEST(test_benchmark_500_particles);
+    RUN_TEST(test_benchmark_fading_trails);
+    return UNITY_END();
+}
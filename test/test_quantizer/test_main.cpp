@@ -0,0 +1,109 @@
+// Tests of the conversion of 16 bit led buffers to 8 bits, and a host benchmark of this output pass, which is what
+// rendering at 16 bits costs on top of rendering at 8 bits.
+#include "render/Quantizer.hpp"
+#include "render/Rgb16.hpp"
+#include <chrono>
+#include <unity.h>
+#include <vector>
+
+const unsigned PIXEL_COUNT = 144 * 10;
+
+void setUp() {}
+void tearDown() {}
+
+void test_8_bit_colors_are_shown_exactly() {
+    Render::Quantizer quantizer;
+    quantizer.init(256);
+    std::vector<Render::Rgb16> highDepthLeds(256);
+    for (unsigned level = 0; level < 256; level++) {
+        highDepthLeds[level] = Render::Rgb16(CRGB(level, 255 - level, level / 2));
+    }
+    std::vector<CRGB> leds(256);
+    // Without a fraction, nothing is carried over to later frames, from the first frame on
+    for (unsigned frame = 0; frame < 100; frame++) {
+        quantizer.convert(highDepthLeds, leds);
+        for (unsigned level = 0; level < 256; level++) {
+            TEST_ASSERT_EQUAL_UINT8(level, leds[level].r);
+            TEST_ASSERT_EQUAL_UINT8(255 - level, leds[level].g);
+            TEST_ASSERT_EQUAL_UINT8(level / 2, leds[level].b);
+        }
+    }
+}
+
+void test_fractions_are_shown_by_dithering() {
+    Render::Quantizer quantizer;
+    quantizer.init(1);
+    // 100.25
+    std::vector<Render::Rgb16> highDepthLeds{Render::Rgb16(100 << 8 | 0x40, 0, 0)};
+    std::vector<CRGB> leds(1);
+    unsigned sum = 0;
+    for (unsigned frame = 0; frame < 400; frame++) {
+        quantizer.convert(highDepthLeds, leds);
+        TEST_ASSERT_TRUE(leds[0].r == 100 || leds[0].r == 101);
+        sum += leds[0].r;
+    }
+    TEST_ASSERT_EQUAL_UINT(400 * 100 + 100, sum);
+}
+
+void test_brightness_scales_levels() {
+    Render::Quantizer quantizer;
+    quantizer.init(1);
+    // Scales by (127 + 1) / 256
+    quantizer.setBrightness(127);
+    std::vector<Render::Rgb16> highDepthLeds{Render::Rgb16(CRGB(200, 0, 254))};
+    std::vector<CRGB> leds(1);
+    quantizer.convert(highDepthLeds, leds);
+    TEST_ASSERT_EQUAL_UINT8(100, leds[0].r);
+    TEST_ASSERT_EQUAL_UINT8(0, leds[0].g);
+    TEST_ASSERT_EQUAL_UINT8(127, leds[0].b);
+}
+
+void test_brightness_0_turns_all_leds_off() {
+    Render::Quantizer quantizer;
+    quantizer.init(PIXEL_COUNT);
+    std::vector<Render::Rgb16> highDepthLeds(PIXEL_COUNT);
+    for (unsigned i = 0; i < PIXEL_COUNT; i++) {
+        highDepthLeds[i] = Render::Rgb16(0xffff - i, i * 45, 0x80ff);
+    }
+    std::vector<CRGB> leds(PIXEL_COUNT);
+    // Errors carried over from frames at full brightness must not light up pixels either
+    quantizer.convert(highDepthLeds, leds);
+    quantizer.setBrightness(0);
+    for (unsigned frame = 0; frame < 100; frame++) {
+        quantizer.convert(highDepthLeds, leds);
+        for (unsigned i = 0; i < PIXEL_COUNT; i++) {
+            TEST_ASSERT_TRUE(leds[i] == CRGB(0));
+        }
+    }
+}
+
+void test_benchmark_output_pass() {
+    Render::Quantizer quantizer;
+    quantizer.init(PIXEL_COUNT);
+    quantizer.setGamma(2.2);
+    std::vector<Render::Rgb16> highDepthLeds(PIXEL_COUNT);
+    for (unsigned i = 0; i < PIXEL_COUNT; i++) {
+        highDepthLeds[i] = Render::Rgb16(i * 45, i * 91, i * 13);
+    }
+    std::vector<CRGB> leds(PIXEL_COUNT);
+    const unsigned frameCount = 20000;
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned frame = 0; frame < frameCount; frame++) {
+        quantizer.convert(highDepthLeds, leds);
+    }
+    std::chrono::duration<double, std::micro> duration = std::chrono::steady_clock::now() - start;
+    char message[128];
+    snprintf(message, sizeof(message), "%u pixels: %.2f us per frame to convert 16 bit to 8 bit with gamma 2.2",
+             PIXEL_COUNT, duration.count() / frameCount);
+    TEST_MESSAGE(message);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_8_bit_colors_are_shown_exactly);
+    RUN_TEST(test_fractions_are_shown_by_dithering);
+    RUN_TEST(test_brightness_scales_levels);
+    RUN_TEST(test_brightness_0_turns_all_leds_off);
+    RUN_TEST(test_benchmark_output_pass);
+    return UNITY_END();
+}
@@ -0,0 +1,156 @@
+// Tests of the cue list parser, the TimerWheel and the CueListPlayer, and a host benchmark of the dispatch latency and
+// of the time spent in CueListPlayer::advance(), which the show loop calls with every frame and every millisecond
+// while waiting. Cue lists are written to a temporary file that the FS shim reads.
+#include "sequencer/CueListPlayer.hpp"
+#include "sequencer/TimerWheel.hpp"
+#include <algorithm>
+#include <chrono>
+#include <unity.h>
+#include <vector>
+
+const char *CUE_LIST_PATH = "/ravelights_test_cues.txt";
+const uint32_t TICK_US = 2000;
+
+fs::FS tempFs(P_tmpdir);
+
+bool writeCueList(const std::string &cueList) {
+    fs::File file = tempFs.open(CUE_LIST_PATH, "w");
+    return file && file.write(reinterpret_cast<const uint8_t *>(cueList.data()), cueList.size()) == cueList.size();
+}
+
+bool isValidCue(const std::string &line) {
+    Sequencer::Cue cue;
+    std::string error;
+    return Sequencer::parseCue(line, cue, error);
+}
+
+void setUp() {}
+void tearDown() { tempFs.remove(CUE_LIST_PATH); }
+
+void test_cues_are_parsed() {
+    Sequencer::Cue cue;
+    std::string error;
+    TEST_ASSERT_TRUE(Sequencer::parseCue("1:30.5 parameter 3 speed -0.25  # comment", cue, error));
+    TEST_ASSERT_EQUAL_UINT32(90500, cue.timeMs);
+    TEST_ASSERT_TRUE(cue.type == Sequencer::CueType::PARAMETER);
+    TEST_ASSERT_EQUAL_UINT32(3, cue.value);
+    TEST_ASSERT_EQUAL_STRING("speed", cue.parameterName);
+    TEST_ASSERT_EQUAL_FLOAT(-0.25f, cue.parameterValue);
+    TEST_ASSERT_TRUE(Sequencer::parseCue(".5 color ff00Aa", cue, error));
+    TEST_ASSERT_EQUAL_UINT32(500, cue.timeMs);
+    TEST_ASSERT_EQUAL_UINT32(0xff00aa, cue.value);
+    TEST_ASSERT_TRUE(isValidCue("71582:47.295 blackout"));
+}
+
+void test_numbers_other_than_plain_decimals_are_rejected() {
+    const char *invalidLines[] = {
+        // Times
+        "nan pattern 1", "inf pattern 1", "0x10 pattern 1", "1e3 pattern 1", "-1 pattern 1", "+1 pattern 1",
+        "1:-5 pattern 1", "1:60 pattern 1", "0x1:00 pattern 1", ". pattern 1", "1.2.3 pattern 1",
+        "71582:47.296 blackout",
+        // Unsigned arguments
+        "1 pattern -1", "1 pattern 0x1", "1 pattern 65536", "1 color 0xffffff", "1 color -1", "1 brightness 256",
+        // Parameters
+        "1 parameter 1 speed nan", "1 parameter 1 speed inf", "1 parameter 1 speed 0x10", "1 parameter 1 speed 1e3",
+        "1 parameter 1 speed 99999999999999999999999999999999999999999999", "1 parameter 1 name_is_too_long 1",
+    };
+    for (const char *line : invalidLines) {
+        TEST_ASSERT_FALSE_MESSAGE(isValidCue(line), line);
+    }
+}
+
+void test_timer_wheel_fires_cues_in_order_and_never_early() {
+    Sequencer::TimerWheel timerWheel(8, 4, TICK_US);
+    timerWheel.reset(0);
+    Sequencer::Cue cue;
+    // Due in several turns of the wheel, in the same slot and in the same tick
+    for (uint32_t timeMs : {30, 3, 3, 17, 0}) {
+        cue.timeMs = timeMs;
+        TEST_ASSERT_TRUE(timerWheel.schedule(timeMs * 1000, cue));
+    }
+    std::vector<uint32_t> firedTimesMs;
+    for (int64_t nowUs = 0; nowUs <= 40000; nowUs += 500) {
+        timerWheel.advance(nowUs, [&](const Sequencer::Cue &firedCue) {
+            TEST_ASSERT_TRUE(nowUs >= firedCue.timeMs * 1000);
+            TEST_ASSERT_TRUE(nowUs < firedCue.timeMs * 1000 + TICK_US);
+            firedTimesMs.push_back(firedCue.timeMs);
+        });
+    }
+    const std::vector<uint32_t> expectedTimesMs{0, 3, 3, 17, 30};
+    TEST_ASSERT_TRUE(firedTimesMs == expectedTimesMs);
+    TEST_ASSERT_EQUAL_UINT(0, timerWheel.getSize());
+}
+
+void test_player_skips_invalid_lines_and_loops() {
+    TEST_ASSERT_TRUE(writeCueList("# intro\n"
+                                  "0 pattern 1\n"
+                                  "0.5 brightness nan\n"
+                                  "1 color ff0000\r\n"
+                                  "2 loop\n"));
+    std::vector<uint32_t> firedTimesMs;
+    int64_t nowUs = 0;
+    Sequencer::CueListPlayer player([&](const Sequencer::Cue &) { firedTimesMs.push_back(nowUs / 1000); });
+    TEST_ASSERT_TRUE(player.start(tempFs, CUE_LIST_PATH, 0));
+    for (; nowUs < 5000000; nowUs += 1000) {
+        player.advance(nowUs);
+    }
+    const std::vector<uint32_t> expectedTimesMs{0, 1000, 2000, 3000, 4000};
+    TEST_ASSERT_TRUE(firedTimesMs == expectedTimesMs);
+    TEST_ASSERT_TRUE(player.isRunning());
+    player.stop();
+    TEST_ASSERT_FALSE(player.isRunning());
+}
+
+void test_benchmark_cue_dispatch() {
+    // 5000 cues 50 ms apart, which is denser than the frames of most patterns
+    const unsigned cueCount = 5000;
+    const uint32_t cueIntervalMs = 50;
+    const char *events[] = {"pattern 3", "color ff00ff", "brightness 100", "parameter 9 speed 2.6", "blackout"};
+    std::string cueList;
+    char line[64];
+    for (unsigned i = 0; i < cueCount; i++) {
+        const uint32_t timeMs = i * cueIntervalMs;
+        snprintf(line, sizeof(line), "%u:%02u.%03u %s\n", timeMs / 60000, timeMs / 1000 % 60, timeMs % 1000,
+                 events[i % 5]);
+        cueList += line;
+    }
+    TEST_ASSERT_TRUE(writeCueList(cueList));
+    int64_t nowUs = 0;
+    std::vector<int64_t> latenessesUs;
+    Sequencer::CueListPlayer player(
+        [&](const Sequencer::Cue &cue) { latenessesUs.push_back(nowUs - (int64_t)cue.timeMs * 1000); });
+    TEST_ASSERT_TRUE(player.start(tempFs, CUE_LIST_PATH, 0));
+    // Advanced every millisecond, like the show loop while it waits
+    std::vector<double> advanceDurationsNs;
+    for (; player.isRunning(); nowUs += 1000) {
+        auto start = std::chrono::steady_clock::now();
+        player.advance(nowUs);
+        advanceDurationsNs.push_back(
+            std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count());
+    }
+    TEST_ASSERT_EQUAL_UINT(cueCount, latenessesUs.size());
+    for (int64_t latenessUs : latenessesUs) {
+        TEST_ASSERT_TRUE(latenessUs >= 0 && latenessUs < TICK_US);
+    }
+    double totalNs = 0;
+    for (double durationNs : advanceDurationsNs) {
+        totalNs += durationNs;
+    }
+    std::sort(advanceDurationsNs.begin(), advanceDurationsNs.end());
+    char message[160];
+    snprintf(message, sizeof(message),
+             "%u cues: advance() takes %.0f ns on average, %.0f ns at the 99.9th percentile, %.0f ns at most",
+             cueCount, totalNs / advanceDurationsNs.size(), advanceDurationsNs[advanceDurationsNs.size() * 999 / 1000],
+             advanceDurationsNs.back());
+    TEST_MESSAGE(message);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_cues_are_parsed);
+    RUN_TEST(test_numbers_other_than_plain_decimals_are_rejected);
+    RUN_TEST(test_timer_wheel_fires_cues_in_order_and_never_early);
+    RUN_TEST(test_player_skips_invalid_lines_and_loops);
+    RUN_TEST(test_benchmark_cue_dispatch);
+    return UNITY_END();
+}
@@ -0,0 +1,155 @@
+// Soak test: runs every pattern for an hour of virtual time each, as the show loop of RaveLights would, but with a
+// Timing::VirtualClock so that it takes seconds. Frames are reproducible from the random seed, so any difference
+// between two runs points at uninitialized state, data races or hidden sources of randomness.
+#include "common/Bench.hpp"
+#include "patterns/Blackout.hpp"
+#include "patterns/BytecodePattern.hpp"
+#include "patterns/Comet.hpp"
+#include "patterns/MovingStrobe.hpp"
+#include "patterns/MultipleStrobeFlashes.hpp"
+#include "patterns/RandomSegments.hpp"
+#include "patterns/RandomSequence.hpp"
+#include "patterns/SingleStrobeFlash.hpp"
+#include "patterns/Twinkle.hpp"
+#include "render/ColumnWorkerPool.hpp"
+#include "render/Quantizer.hpp"
+#include "timing/Clock.hpp"
+#include "timing/FrameScheduler.hpp"
+#include <functional>
+#include <memory>
+#include <unity.h>
+#include <vector>
+
+using Bench::COLUMN_COUNT;
+using Bench::ROW_COUNT;
+using Bench::SEED;
+
+const int64_t SOAK_DURATION_US = 60LL * 60 * 1000000;
+// Time that FastLED.show() takes for 144 pixels per pin with the I2S driver
+const int64_t SHOW_DURATION_US = 4400;
+
+struct SoakResult {
+    uint64_t checksum{14695981039346656037ULL};
+    uint32_t frameCount{0};
+    uint32_t missCount{0};
+    uint32_t performCount{0};
+    bool hasStalled{false};
+};
+
+std::vector<std::function<std::shared_ptr<Pattern::AbstractPattern>()>> patternFactories() {
+    return {
+        [] { return std::make_shared<Pattern::RandomSegments>(); },
+        [] { return std::make_shared<Pattern::RandomSequence>(); },
+        [] { return std::make_shared<Pattern::SingleStrobeFlash>(); },
+        [] { return std::make_shared<Pattern::MultipleStrobeFlashes>(); },
+        [] { return std::make_shared<Pattern::Twinkle>(); },
+        [] { return std::make_shared<Pattern::Comet>(); },
+        [] { return std::make_shared<Pattern::MovingStrobe>(); },
+        [] { return std::make_shared<Pattern::MovingStrobe>(0.7, 0.8); },
+        [] { return std::make_shared<Pattern::Blackout>(); },
+        [] { return std::make_shared<Pattern::BytecodePattern>(); },
+    };
+}
+
+// The show loop of RaveLights::show() without web server, palettes and audio
+SoakResult runShow(std::shared_ptr<Pattern::AbstractPattern> pattern, Render::ColumnWorkerPool *workerPool) {
+    SoakResult result;
+    Timing::VirtualClock clock;
+    std::vector<CRGB> leds(ROW_COUNT * COLUMN_COUNT);
+    std::vector<Render::Rgb16> highDepthLeds(leds.size());
+    Render::Quantizer quantizer;
+    quantizer.init(leds.size());
+    // Hashes every shown frame (FNV-1a) and lets the show take its time
+    Timing::FrameScheduler frameScheduler(clock, [&] {
+        for (const CRGB &pixel : leds) {
+            for (uint8_t channel : pixel.raw) {
+                result.checksum = (result.checksum ^ channel) * 1099511628211ULL;
+            }
+        }
+        clock.advanceUs(SHOW_DURATION_US);
+    });
+    pattern->setRandomSeed(SEED);
+    pattern->init(ROW_COUNT, COLUMN_COUNT);
+    pattern->setFrameScheduler(&frameScheduler);
+    pattern->setHighDepthBuffer(&highDepthLeds);
+    pattern->setWorkerPool(workerPool);
+    const bool usesHighDepthBuffer = pattern->usesHighDepthBuffer();
+    frameScheduler.setOutputPass([&] {
+        if (usesHighDepthBuffer) {
+            quantizer.convert(highDepthLeds, leds);
+        }
+    });
+
+    // Shows a black frame first, so that the scheduler knows the show duration when the schedule starts
+    frameScheduler.presentImmediately();
+    frameScheduler.resync();
+    while (clock.nowUs() < SOAK_DURATION_US) {
+        const int64_t performStartUs = clock.nowUs();
+        // Stands in for FastLED.clear(false), which only clears the buffers registered with FastLED
+        std::fill(leds.begin(), leds.end(), CRGB(0));
+        if (usesHighDepthBuffer) {
+            std::fill(highDepthLeds.begin(), highDepthLeds.end(), Render::Rgb16());
+        }
+        unsigned offDurationMs = pattern->perform(leds, CRGB(CRGB::Purple));
+        frameScheduler.hold(offDurationMs * 1000);
+        frameScheduler.waitForDeadline();
+        result.performCount++;
+        if (clock.nowUs() == performStartUs) {
+            // The show loop would spin forever
+            result.hasStalled = true;
+            break;
+        }
+    }
+    result.frameCount = frameScheduler.getFrameCount();
+    result.missCount = frameScheduler.getMissCount();
+    return result;
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_patterns_run_for_an_hour() {
+    auto factories = patternFactories();
+    for (unsigned i = 0; i < factories.size(); i++) {
+        SoakResult result = runShow(factories[i](), nullptr);
+        char message[128];
+        snprintf(message, sizeof(message), "Pattern #%u: %u performs, %u timed frames, %u missed", i,
+                 result.performCount, result.frameCount, result.missCount);
+        TEST_MESSAGE(message);
+        TEST_ASSERT_FALSE_MESSAGE(result.hasStalled, "perform() returned without letting time pass");
+        // Virtual time doesn't pass while rendering, so every deadline can be met
+        TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, result.missCount, message);
+    }
+}
+
+void test_shows_are_reproducible() {
+    auto factories = patternFactories();
+    for (unsigned i = 0; i < factories.size(); i++) {
+        SoakResult first = runShow(factories[i](), nullptr);
+        SoakResult second = runShow(factories[i](), nullptr);
+        char message[32];
+        snprintf(message, sizeof(message), "Pattern #%u", i);
+        TEST_ASSERT_EQUAL_UINT64_MESSAGE(first.checksum, second.checksum, message);
+        TEST_ASSERT_EQUAL_UINT32_MESSAGE(first.frameCount, second.frameCount, message);
+    }
+}
+
+void test_parallel_rendering_matches_serial_rendering() {
+    Render::ColumnWorkerPool workerPool(3, 0);
+    auto factories = patternFactories();
+    for (unsigned i = 0; i < factories.size(); i++) {
+        SoakResult serial = runShow(factories[i](), nullptr);
+        SoakResult parallel = runShow(factories[i](), &workerPool);
+        char message[32];
+        snprintf(message, sizeof(message), "Pattern #%u", i);
+        TEST_ASSERT_EQUAL_UINT64_MESSAGE(serial.checksum, parallel.checksum, message);
+    }
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_patterns_run_for_an_hour);
+    RUN_TEST(test_shows_are_reproducible);
+    RUN_TEST(test_parallel_rendering_matches_serial_rendering);
+    return UNITY_END();
+}
@@ -0,0 +1,100 @@
+// Tests of the ColumnWorkerPool and a host benchmark of the patterns that render with parallelForColumns().
+// Run it with ThreadSanitizer through `pio test -e native_tsan -f test_worker_pool` after changing the pool.
+// The speedup depends on the cores of the development machine, so it is reported but not asserted.
+#include "common/Bench.hpp"
+#include "patterns/Comet.hpp"
+#include "patterns/MovingStrobe.hpp"
+#include "render/ColumnWorkerPool.hpp"
+#include <atomic>
+#include <thread>
+#include <unity.h>
+#include <vector>
+
+using Bench::COLUMN_COUNT;
+using Bench::ROW_COUNT;
+using Bench::measureFrameUs;
+// A rig of 128 lights, large enough that rendering outweighs the barrier at the end of each frame
+const unsigned LARGE_RIG_COLUMN_COUNT = 128;
+// The benchmark scales up to this many threads, whatever the cores of the development machine
+const unsigned MAX_THREAD_COUNT = std::max(4u, std::thread::hardware_concurrency());
+
+void setUp() {}
+void tearDown() {}
+
+void test_every_column_is_rendered_exactly_once() {
+    for (unsigned workerCount : {0, 1, 3}) {
+        Render::ColumnWorkerPool workerPool(workerCount);
+        for (unsigned columnCount : {0, 1, 2, 3, 10, 17}) {
+            std::vector<std::atomic<unsigned>> renderCounts(columnCount);
+            for (auto &renderCount : renderCounts) {
+                renderCount = 0;
+            }
+            // Many frames in a row, so that workers that fall behind by a frame are noticed
+            const unsigned frameCount = 1000;
+            for (unsigned frame = 0; frame < frameCount; frame++) {
+                workerPool.parallelForColumns(columnCount, [&](unsigned firstColumn, unsigned endColumn) {
+                    for (unsigned columnIndex = firstColumn; columnIndex < endColumn; columnIndex++) {
+                        renderCounts[columnIndex]++;
+                    }
+                });
+            }
+            for (unsigned columnIndex = 0; columnIndex < columnCount; columnIndex++) {
+                TEST_ASSERT_EQUAL_UINT(frameCount, renderCounts[columnIndex]);
+            }
+        }
+    }
+}
+
+void test_rendering_has_finished_when_parallel_for_columns_returns() {
+    Render::ColumnWorkerPool workerPool(3);
+    // Plain memory, so that ThreadSanitizer reports a missing barrier
+    std::vector<unsigned> columns(COLUMN_COUNT, 0);
+    for (unsigned frame = 1; frame <= 1000; frame++) {
+        workerPool.parallelForColumns(COLUMN_COUNT, [&](unsigned firstColumn, unsigned endColumn) {
+            for (unsigned columnIndex = firstColumn; columnIndex < endColumn; columnIndex++) {
+                columns[columnIndex]++;
+            }
+        });
+        for (unsigned columnIndex = 0; columnIndex < COLUMN_COUNT; columnIndex++) {
+            TEST_ASSERT_EQUAL_UINT(frame, columns[columnIndex]);
+        }
+    }
+}
+
+// Prints the time per frame of the pattern on 1 up to MAX_THREAD_COUNT threads and the speedup over 1 thread
+template <typename PatternType>
+void reportScaling(const char *name, unsigned columnCount, unsigned performCount) {
+    char message[160];
+    double serialUs = 0;
+    for (unsigned workerCount = 0; workerCount < MAX_THREAD_COUNT; workerCount++) {
+        Render::ColumnWorkerPool workerPool(workerCount);
+        // The same seed renders the same frames on any number of threads
+        PatternType pattern;
+        const double frameUs =
+            measureFrameUs(pattern, performCount, workerCount ? &workerPool : nullptr, ROW_COUNT, columnCount);
+        if (workerCount == 0) {
+            serialUs = frameUs;
+        }
+        snprintf(message, sizeof(message), "%s on %ux%u: %u threads, %.2f us per frame, %.2fx", name, columnCount,
+                 ROW_COUNT, workerCount + 1, frameUs, serialUs / frameUs);
+        TEST_MESSAGE(message);
+    }
+}
+
+void test_benchmark_parallel_rendering() {
+    char message[64];
+    snprintf(message, sizeof(message), "%u host cores", std::thread::hardware_concurrency());
+    TEST_MESSAGE(message);
+    for (unsigned columnCount : {COLUMN_COUNT, LARGE_RIG_COLUMN_COUNT}) {
+        reportScaling<Pattern::Comet>("Comet", columnCount, 100);
+        reportScaling<Pattern::MovingStrobe>("MovingStrobe", columnCount, 2000);
+    }
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_every_column_is_rendered_exactly_once);
+    RUN_TEST(test_rendering_has_finished_when_parallel_for_columns_returns);
+    RUN_TEST(test_benchmark_parallel_rendering);
+    return UNITY_END();
+}